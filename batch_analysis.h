@@ -0,0 +1,273 @@
+#ifndef BATCH_ANALYSIS_H
+#define BATCH_ANALYSIS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <wchar.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h> // For sysconf
+#include <sys/stat.h>
+#include "batch_reader.h"
+#include "segmenter.h"
+#include "text_decoder.h"
+#include "compressed_reader.h" // For detect_input_format
+#include "word_freq.h"
+#include "histogram.h"         // For print_word_histogram
+
+// Batch mode: classify many (typically small) documents, one verdict line per
+// file. Files are read by batch_reader.h and analysed by a pool of workers.
+// Each worker counts a document's words into a table it resets per document
+// and merges into its own running total; the totals are merged into the run's
+// word table as the workers finish.
+
+typedef struct BatchOptions {
+    TextEncoding encoding;
+    unsigned queue_depth; // Opens/reads kept in flight (0 = default)
+    unsigned workers;     // Analysis threads (0 = one per CPU)
+    bool prefer_uring;
+} BatchOptions;
+
+typedef struct BatchContext {
+    BatchReader *reader;
+    const BatchOptions *options;
+    pthread_mutex_t print_lock;
+    size_t files_analysed;
+    size_t files_failed;
+    WordTable words;  // Every document's words, merged under print_lock
+    bool words_valid; // False if a worker could not count its words
+} BatchContext;
+
+// =======================================================
+// INPUT LIST (files as given, directories expanded one level)
+// =======================================================
+typedef struct PathList {
+    char **paths;
+    size_t count;
+    size_t capacity;
+} PathList;
+
+static inline int path_list_add(PathList *list, const char *dir, const char *name) {
+    if (list->count == list->capacity) {
+        size_t capacity = (list->capacity == 0) ? 1024 : list->capacity * 2;
+        char **grown = (char **)realloc(list->paths, capacity * sizeof(char *));
+        if (grown == NULL) return -1;
+        list->paths = grown;
+        list->capacity = capacity;
+    }
+
+    size_t dir_len = (dir != NULL) ? strlen(dir) : 0;
+    size_t name_len = strlen(name);
+    char *path = (char *)malloc(dir_len + name_len + 2);
+    if (path == NULL) return -1;
+
+    if (dir != NULL) {
+        memcpy(path, dir, dir_len);
+        path[dir_len] = '/';
+        memcpy(path + dir_len + 1, name, name_len + 1);
+    } else {
+        memcpy(path, name, name_len + 1);
+    }
+    list->paths[list->count++] = path;
+    return 0;
+}
+
+static inline int collect_batch_inputs(char **inputs, size_t input_count, PathList *list) {
+    memset(list, 0, sizeof(PathList));
+
+    for (size_t k = 0; k < input_count; k++) {
+        struct stat st;
+        if (stat(inputs[k], &st) == 0 && S_ISDIR(st.st_mode)) {
+            DIR *dir = opendir(inputs[k]);
+            if (dir == NULL) {
+                perror("Error opening directory");
+                continue;
+            }
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != NULL) {
+                if (entry->d_name[0] == '.') continue; // ".", ".." and hidden files
+#ifdef DT_DIR
+                if (entry->d_type == DT_DIR) continue;
+#endif
+                if (path_list_add(list, inputs[k], entry->d_name) != 0) {
+                    closedir(dir);
+                    return -1;
+                }
+            }
+            closedir(dir);
+        } else if (path_list_add(list, NULL, inputs[k]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static inline void path_list_free(PathList *list) {
+    for (size_t k = 0; k < list->count; k++) free(list->paths[k]);
+    free(list->paths);
+    memset(list, 0, sizeof(PathList));
+}
+
+// =======================================================
+// ANALYSIS WORKERS
+// =======================================================
+// Counts the document's words into `document` when it is not NULL
+static inline void analyse_batch_item(BatchContext *ctx, const BatchItem *item, WordTable *document) {
+    const char *status = NULL;
+    size_t eng_chars = 0;
+    size_t fre_chars = 0;
+    size_t invalid_sequences = 0;
+
+    if (item->error != 0) {
+        status = strerror(item->error);
+    } else if (detect_input_format(item->data, item->length) != INPUT_PLAIN) {
+        status = "compressed input is not supported in batch mode";
+    } else {
+        wchar_t *text = (wchar_t *)malloc((TEXT_DECODER_MAX_OUTPUT(item->length) + 1) * sizeof(wchar_t));
+        if (text == NULL) {
+            status = "out of memory";
+        } else {
+            TextDecoder decoder;
+            text_decoder_init(&decoder, ctx->options->encoding);
+            size_t length = text_decoder_decode(&decoder, item->data, item->length, text);
+            length += text_decoder_finish(&decoder, text + length);
+            invalid_sequences = decoder.invalid_sequences;
+
+            run_sliding_windows(text, length, false, &eng_chars, &fre_chars);
+            if (document != NULL) {
+                count_words_in_buffer(text, length, document);
+            }
+            free(text);
+        }
+    }
+
+    pthread_mutex_lock(&ctx->print_lock);
+    if (status != NULL) {
+        printf("%s: ERROR (%s)\n", item->path, status);
+        ctx->files_failed++;
+    } else {
+        size_t total = eng_chars + fre_chars;
+        if (total == 0) {
+            printf("%s: UNDETERMINED", item->path);
+        } else {
+            double prob_english = ((double)eng_chars / (double)total) * 100.0;
+            printf("%s: %s (English %.2f%% | French %.2f%%)", item->path,
+                   (eng_chars >= fre_chars) ? "ENGLISH" : "FRENCH", prob_english, 100.0 - prob_english);
+        }
+        if (invalid_sequences > 0) {
+            printf(" [%zu invalid sequences]", invalid_sequences);
+        }
+        printf("\n");
+        ctx->files_analysed++;
+    }
+    pthread_mutex_unlock(&ctx->print_lock);
+}
+
+static void *batch_worker_main(void *arg) {
+    BatchContext *ctx = (BatchContext *)arg;
+    BatchItem item;
+    WordTable document;
+    WordTable total;
+    bool counting = (word_table_init(&document) == 0);
+    if (counting && word_table_init(&total) != 0) {
+        word_table_free(&document);
+        counting = false;
+    }
+
+    while (batch_reader_next(ctx->reader, &item)) {
+        if (counting) {
+            word_table_reset(&document); // O(1): the previous document's words are dropped
+        }
+        analyse_batch_item(ctx, &item, counting ? &document : NULL);
+        if (counting) {
+            word_table_merge(&total, &document);
+        }
+        free(item.data);
+    }
+
+    pthread_mutex_lock(&ctx->print_lock);
+    if (counting && ctx->words_valid) {
+        word_table_merge(&ctx->words, &total);
+    } else {
+        ctx->words_valid = false;
+    }
+    pthread_mutex_unlock(&ctx->print_lock);
+
+    if (counting) {
+        word_table_free(&document);
+        word_table_free(&total);
+    }
+    return NULL;
+}
+
+// Runs batch mode over files and/or directories. Returns an exit status.
+static inline int run_batch_analysis(char **inputs, size_t input_count, const BatchOptions *options) {
+    PathList list;
+    if (collect_batch_inputs(inputs, input_count, &list) != 0) {
+        fprintf(stderr, "Error: Failed to allocate the batch file list.\n");
+        path_list_free(&list);
+        return EXIT_FAILURE;
+    }
+    if (list.count == 0) {
+        fprintf(stderr, "Error: No input files for batch mode.\n");
+        path_list_free(&list);
+        return EXIT_FAILURE;
+    }
+
+    unsigned workers = options->workers;
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+
+    BatchReader reader;
+    if (batch_reader_start(&reader, list.paths, list.count, options->queue_depth, options->prefer_uring) != 0) {
+        path_list_free(&list);
+        return EXIT_FAILURE;
+    }
+
+    BatchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.reader = &reader;
+    ctx.options = options;
+    ctx.words_valid = (word_table_init(&ctx.words) == 0);
+    pthread_mutex_init(&ctx.print_lock, NULL);
+
+    pthread_t *threads = (pthread_t *)malloc(workers * sizeof(pthread_t));
+    unsigned started = 0;
+    if (threads != NULL) {
+        for (; started < workers; started++) {
+            if (pthread_create(&threads[started], NULL, batch_worker_main, &ctx) != 0) break;
+        }
+    }
+    if (started == 0) {
+        batch_worker_main(&ctx); // Analyse on this thread instead
+    }
+    for (unsigned t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+
+    bool used_uring = reader.using_uring;
+    unsigned depth = reader.depth;
+    batch_reader_stop(&reader);
+    pthread_mutex_destroy(&ctx.print_lock);
+
+    printf("\n--- Batch Complete: %zu files analysed, %zu failed (%s, %u in flight, %u workers) ---\n",
+           ctx.files_analysed, ctx.files_failed, used_uring ? "io_uring" : "thread pool",
+           depth, (started > 0) ? started : 1);
+    if (ctx.words_valid) {
+        print_word_histogram(&ctx.words);
+    } else {
+        fprintf(stderr, "Error: Failed to allocate the batch word tables.\n");
+    }
+    word_table_free(&ctx.words);
+
+    path_list_free(&list);
+    return (ctx.files_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif // BATCH_ANALYSIS_H
@@ -0,0 +1,657 @@
+#ifndef BATCH_READER_H
+#define BATCH_READER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint64_t
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>   // For nanosleep
+
+// Asynchronous input stage for batches of many small files. A configurable
+// number of opens/reads are kept in flight and every completed file is handed
+// to whichever analysis worker calls batch_reader_next first, so the CPU never
+// sits idle waiting on a blocking open or read.
+//
+// On Linux the I/O runs on io_uring (raw syscalls, no liburing needed). If the
+// kernel lacks io_uring or the required opcodes (older than 5.6, or blocked by
+// a seccomp profile), a pool of blocking reader threads is used instead; the
+// pool also takes over if the ring fails part way through a batch.
+
+#define BATCH_DEFAULT_QUEUE_DEPTH 64
+#define BATCH_MAX_QUEUE_DEPTH 4096
+#define BATCH_INITIAL_READ_SIZE (16 * 1024) // Covers typical 1-10 KB documents in one read
+
+// One completed file. `data` is malloc'd and owned by the caller after batch_reader_next.
+typedef struct BatchItem {
+    size_t index;        // Position in the path list
+    const char *path;
+    unsigned char *data;
+    size_t length;
+    int error;           // errno value, 0 on success
+} BatchItem;
+
+typedef struct BatchReader {
+    char **paths;
+    size_t path_count;
+    unsigned depth;
+
+    // Completed-item queue shared with the analysis workers
+    BatchItem *ready;
+    size_t ready_capacity;
+    size_t ready_head;
+    size_t ready_count;
+    size_t producers_running;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+
+    // Fallback thread pool: next path to claim
+    size_t next_path;
+
+    pthread_t *threads;
+    size_t thread_count;
+    bool using_uring;
+} BatchReader;
+
+// =======================================================
+// READY QUEUE
+// =======================================================
+static inline void batch_push_ready(BatchReader *reader, const BatchItem *item) {
+    pthread_mutex_lock(&reader->lock);
+    while (reader->ready_count == reader->ready_capacity) {
+        pthread_cond_wait(&reader->not_full, &reader->lock);
+    }
+    size_t tail = (reader->ready_head + reader->ready_count) % reader->ready_capacity;
+    reader->ready[tail] = *item;
+    reader->ready_count++;
+    pthread_cond_signal(&reader->not_empty);
+    pthread_mutex_unlock(&reader->lock);
+}
+
+static inline void batch_producer_finished(BatchReader *reader) {
+    pthread_mutex_lock(&reader->lock);
+    reader->producers_running--;
+    pthread_cond_broadcast(&reader->not_empty);
+    pthread_mutex_unlock(&reader->lock);
+}
+
+// Blocks until a file is ready. Returns false once every file has been handed out.
+// Safe to call from several analysis threads.
+static inline bool batch_reader_next(BatchReader *reader, BatchItem *out) {
+    pthread_mutex_lock(&reader->lock);
+    while (reader->ready_count == 0 && reader->producers_running > 0) {
+        pthread_cond_wait(&reader->not_empty, &reader->lock);
+    }
+    if (reader->ready_count == 0) {
+        pthread_mutex_unlock(&reader->lock);
+        return false;
+    }
+    *out = reader->ready[reader->ready_head];
+    reader->ready_head = (reader->ready_head + 1) % reader->ready_capacity;
+    reader->ready_count--;
+    pthread_cond_signal(&reader->not_full);
+    pthread_mutex_unlock(&reader->lock);
+    return true;
+}
+
+// =======================================================
+// FALLBACK: POOL OF BLOCKING READER THREADS
+// =======================================================
+static inline int read_whole_file(const char *path, unsigned char **out_data, size_t *out_length) {
+    *out_data = NULL;
+    *out_length = 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno;
+
+    struct stat st;
+    size_t capacity = BATCH_INITIAL_READ_SIZE;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        capacity = (size_t)st.st_size + 1; // +1 so EOF is seen without a regrow
+    }
+
+    unsigned char *data = (unsigned char *)malloc(capacity);
+    if (data == NULL) {
+        close(fd);
+        return ENOMEM;
+    }
+
+    size_t length = 0;
+    for (;;) {
+        if (length == capacity) {
+            unsigned char *grown = (unsigned char *)realloc(data, capacity * 2);
+            if (grown == NULL) {
+                free(data);
+                close(fd);
+                return ENOMEM;
+            }
+            data = grown;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, data + length, capacity - length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int err = errno;
+            free(data);
+            close(fd);
+            return err;
+        }
+        if (n == 0) break;
+        length += (size_t)n;
+    }
+
+    close(fd);
+    *out_data = data;
+    *out_length = length;
+    return 0;
+}
+
+static void *batch_pool_thread_main(void *arg) {
+    BatchReader *reader = (BatchReader *)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&reader->lock);
+        size_t index = reader->next_path++;
+        pthread_mutex_unlock(&reader->lock);
+        if (index >= reader->path_count) break;
+
+        BatchItem item = { index, reader->paths[index], NULL, 0, 0 };
+        item.error = read_whole_file(item.path, &item.data, &item.length);
+        batch_push_ready(reader, &item);
+    }
+
+    batch_producer_finished(reader);
+    return NULL;
+}
+
+// =======================================================
+// IO_URING BACKEND (Linux only)
+// =======================================================
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+typedef struct UringRing {
+    int fd;
+    unsigned sq_entries;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring_ptr;
+    void *cq_ring_ptr;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+} UringRing;
+
+// Stages each in-flight file goes through; one operation per slot at a time
+enum { URING_STAGE_OPEN, URING_STAGE_READ, URING_STAGE_CLOSE };
+
+#define URING_DRAIN_POLLS 1000 // 1 ms apart: completions still owed when the ring fails
+
+typedef struct UringSlot {
+    BatchItem item;
+    int fd;
+    int stage;
+    size_t capacity;
+    bool active;  // Holds an unfinished file
+    bool pending; // Its operation was submitted and has not completed (only tracked after a failure)
+} UringSlot;
+
+static inline int uring_setup(UringRing *ring, unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(UringRing));
+
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) return -1;
+
+    ring->sq_entries = params.sq_entries;
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) {
+        ring->sq_ring_size = ring->cq_ring_size;
+    }
+
+    ring->sq_ring_ptr = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring_ptr == MAP_FAILED) {
+        close(ring->fd);
+        return -1;
+    }
+
+    if (single_mmap) {
+        ring->cq_ring_ptr = ring->sq_ring_ptr;
+    } else {
+        ring->cq_ring_ptr = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring_ptr == MAP_FAILED) {
+            munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+            close(ring->fd);
+            return -1;
+        }
+    }
+
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+                                             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        if (!single_mmap) munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+        munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+        close(ring->fd);
+        return -1;
+    }
+
+    char *sq = (char *)ring->sq_ring_ptr;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+
+    char *cq = (char *)ring->cq_ring_ptr;
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return 0;
+}
+
+static inline void uring_teardown(UringRing *ring) {
+    munmap(ring->sqes, ring->sq_entries * sizeof(struct io_uring_sqe));
+    if (ring->cq_ring_ptr != ring->sq_ring_ptr) munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+    munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+// True if the kernel implements every opcode the reader uses
+static inline bool uring_supports_ops(const UringRing *ring) {
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = (struct io_uring_probe *)calloc(1, probe_size);
+    if (probe == NULL) return false;
+
+    bool ok = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256) >= 0;
+    const int needed[] = { IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE };
+    for (size_t k = 0; ok && k < sizeof(needed) / sizeof(needed[0]); k++) {
+        ok = needed[k] <= probe->last_op && (probe->ops[needed[k]].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    return ok;
+}
+
+// Queues one SQE (the ring is sized so there is always room: one op per slot)
+static inline struct io_uring_sqe *uring_get_sqe(UringRing *ring) {
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+static inline void uring_prep_open(UringRing *ring, UringSlot *slot, uint64_t slot_id) {
+    struct io_uring_sqe *sqe = uring_get_sqe(ring);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)slot->item.path;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe->user_data = slot_id;
+    slot->stage = URING_STAGE_OPEN;
+}
+
+static inline void uring_prep_read(UringRing *ring, UringSlot *slot, uint64_t slot_id) {
+    struct io_uring_sqe *sqe = uring_get_sqe(ring);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = slot->fd;
+    sqe->addr = (uint64_t)(uintptr_t)(slot->item.data + slot->item.length);
+    sqe->len = (unsigned)(slot->capacity - slot->item.length);
+    sqe->off = slot->item.length;
+    sqe->user_data = slot_id;
+    slot->stage = URING_STAGE_READ;
+}
+
+static inline void uring_prep_close(UringRing *ring, UringSlot *slot, uint64_t slot_id) {
+    struct io_uring_sqe *sqe = uring_get_sqe(ring);
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = slot->fd;
+    sqe->user_data = slot_id;
+    slot->stage = URING_STAGE_CLOSE;
+}
+
+typedef struct UringJob {
+    BatchReader *reader;
+    UringRing ring;
+} UringJob;
+
+// Starts the next unread path in `slot`; returns false when none are left
+static inline bool uring_start_next(UringJob *job, UringSlot *slot, uint64_t slot_id) {
+    BatchReader *reader = job->reader;
+    if (reader->next_path >= reader->path_count) return false;
+
+    size_t index = reader->next_path++;
+    memset(slot, 0, sizeof(UringSlot));
+    slot->item.index = index;
+    slot->item.path = reader->paths[index];
+    slot->fd = -1;
+    slot->active = true;
+    uring_prep_open(&job->ring, slot, slot_id);
+    return true;
+}
+
+// Advances a slot after its operation completed. Returns true if the file is finished.
+static inline bool uring_advance(UringJob *job, UringSlot *slot, uint64_t slot_id, int res) {
+    switch (slot->stage) {
+        case URING_STAGE_OPEN:
+            if (res < 0) {
+                slot->item.error = -res;
+                return true;
+            }
+            slot->fd = res;
+            slot->capacity = BATCH_INITIAL_READ_SIZE;
+            slot->item.data = (unsigned char *)malloc(slot->capacity);
+            if (slot->item.data == NULL) {
+                slot->item.error = ENOMEM;
+                uring_prep_close(&job->ring, slot, slot_id);
+                return false;
+            }
+            uring_prep_read(&job->ring, slot, slot_id);
+            return false;
+
+        case URING_STAGE_READ:
+            if (res == -EINTR || res == -EAGAIN) {
+                uring_prep_read(&job->ring, slot, slot_id);
+                return false;
+            }
+            if (res < 0) {
+                slot->item.error = -res;
+                uring_prep_close(&job->ring, slot, slot_id);
+                return false;
+            }
+            // Only an empty read is end of file: pipes and devices return short reads
+            if (res == 0) {
+                uring_prep_close(&job->ring, slot, slot_id);
+                return false;
+            }
+            slot->item.length += (size_t)res;
+            if (slot->item.length == slot->capacity) {
+                unsigned char *grown = (unsigned char *)realloc(slot->item.data, slot->capacity * 2);
+                if (grown == NULL) {
+                    slot->item.error = ENOMEM;
+                    uring_prep_close(&job->ring, slot, slot_id);
+                    return false;
+                }
+                slot->item.data = grown;
+                slot->capacity *= 2;
+            }
+            uring_prep_read(&job->ring, slot, slot_id);
+            return false;
+
+        default: // URING_STAGE_CLOSE
+            return true;
+    }
+}
+
+// Releases what a slot holds once it has nothing in flight: its operation
+// completed with `res` (`completed`) or was never submitted
+static inline void uring_release_slot(UringSlot *slot, bool completed, int res) {
+    if (slot->stage == URING_STAGE_OPEN) {
+        if (completed && res >= 0) close(res);
+    } else if (slot->stage == URING_STAGE_READ || !completed) {
+        close(slot->fd);
+    }
+    free(slot->item.data);
+    slot->item.data = NULL;
+    slot->item.length = 0;
+}
+
+// Called when io_uring_enter fails for good. Takes back the SQEs the kernel
+// never consumed, collects the completions it still owes, then reads every
+// unfinished file again with blocking I/O so each one is still reported. The
+// buffer of an operation that never completes is left to the kernel rather
+// than freed under it.
+static inline void uring_abandon(UringJob *job, UringSlot *slots, unsigned depth) {
+    UringRing *ring = &job->ring;
+    unsigned owed = 0;
+
+    for (unsigned s = 0; s < depth; s++) {
+        slots[s].pending = slots[s].active;
+    }
+    unsigned sq_head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    for (unsigned k = sq_head; k != *ring->sq_tail; k++) {
+        const struct io_uring_sqe *sqe = &ring->sqes[ring->sq_array[k & *ring->sq_mask]];
+        UringSlot *slot = &slots[sqe->user_data];
+        slot->pending = false;
+        uring_release_slot(slot, false, 0);
+    }
+    __atomic_store_n(ring->sq_tail, sq_head, __ATOMIC_RELEASE);
+    for (unsigned s = 0; s < depth; s++) {
+        if (slots[s].pending) owed++;
+    }
+
+    // Completions are posted without io_uring_enter; sleeping lets them run
+    for (int poll = 0; owed > 0 && poll < URING_DRAIN_POLLS; poll++) {
+        unsigned head = *ring->cq_head;
+        unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            UringSlot *slot = &slots[cqe->user_data];
+            if (slot->pending) {
+                slot->pending = false;
+                uring_release_slot(slot, true, cqe->res);
+                owed--;
+            }
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        if (owed > 0) {
+            struct timespec pause = { 0, 1000000 };
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    for (unsigned s = 0; s < depth; s++) {
+        UringSlot *slot = &slots[s];
+        if (!slot->active) continue;
+
+        if (slot->pending && slot->stage == URING_STAGE_READ) {
+            close(slot->fd); // The read holds its own reference to the file
+        }
+        BatchItem item = { slot->item.index, slot->item.path, NULL, 0, 0 };
+        item.error = read_whole_file(item.path, &item.data, &item.length);
+        batch_push_ready(job->reader, &item);
+        slot->active = false;
+    }
+}
+
+// Hands the paths no slot reached to a pool of blocking readers; this thread
+// becomes one of them
+static inline void uring_fall_back_to_pool(BatchReader *reader) {
+    pthread_mutex_lock(&reader->lock);
+    size_t remaining = reader->path_count - reader->next_path;
+    for (size_t t = 1; t < reader->depth && t <= remaining; t++) {
+        if (pthread_create(&reader->threads[t], NULL, batch_pool_thread_main, reader) != 0) break;
+        reader->thread_count++;
+        reader->producers_running++;
+    }
+    pthread_mutex_unlock(&reader->lock);
+
+    batch_pool_thread_main(reader);
+}
+
+static void *batch_uring_thread_main(void *arg) {
+    UringJob *job = (UringJob *)arg;
+    BatchReader *reader = job->reader;
+    UringRing *ring = &job->ring;
+    unsigned depth = reader->depth;
+
+    UringSlot *slots = (UringSlot *)calloc(depth, sizeof(UringSlot));
+    unsigned in_flight = 0;
+    bool ring_failed = (slots == NULL);
+
+    if (slots != NULL) {
+        for (unsigned s = 0; s < depth && uring_start_next(job, &slots[s], s); s++) {
+            in_flight++;
+        }
+    } else {
+        fprintf(stderr, "Warning: Failed to allocate io_uring slots; using blocking reads.\n");
+    }
+
+    while (in_flight > 0) {
+        unsigned to_submit = *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if (syscall(__NR_io_uring_enter, ring->fd, to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+            errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            fprintf(stderr, "Warning: io_uring_enter failed (%s); finishing with blocking reads.\n", strerror(errno));
+            uring_abandon(job, slots, depth);
+            ring_failed = true;
+            break;
+        }
+
+        unsigned head = *ring->cq_head;
+        unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            uint64_t slot_id = cqe->user_data;
+            UringSlot *slot = &slots[slot_id];
+
+            if (uring_advance(job, slot, slot_id, cqe->res)) {
+                if (slot->item.error != 0) {
+                    free(slot->item.data);
+                    slot->item.data = NULL;
+                    slot->item.length = 0;
+                }
+                batch_push_ready(reader, &slot->item);
+                if (!uring_start_next(job, slot, slot_id)) {
+                    slot->active = false;
+                    in_flight--;
+                }
+            }
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    free(slots);
+    uring_teardown(ring);
+    free(job);
+
+    if (ring_failed) {
+        uring_fall_back_to_pool(reader); // Finishes this producer
+    } else {
+        batch_producer_finished(reader);
+    }
+    return NULL;
+}
+
+// Tries to start the io_uring backend; returns false so the caller can fall back
+static inline bool batch_start_uring(BatchReader *reader) {
+    UringJob *job = (UringJob *)calloc(1, sizeof(UringJob));
+    if (job == NULL) return false;
+    job->reader = reader;
+
+    if (uring_setup(&job->ring, reader->depth) != 0) {
+        free(job);
+        return false;
+    }
+    if (job->ring.sq_entries < reader->depth || !uring_supports_ops(&job->ring)) {
+        uring_teardown(&job->ring);
+        free(job);
+        return false;
+    }
+
+    reader->producers_running = 1;
+    if (pthread_create(&reader->threads[0], NULL, batch_uring_thread_main, job) != 0) {
+        reader->producers_running = 0;
+        uring_teardown(&job->ring);
+        free(job);
+        return false;
+    }
+    reader->thread_count = 1;
+    return true;
+}
+
+#else
+
+static inline bool batch_start_uring(BatchReader *reader) {
+    (void)reader;
+    return false;
+}
+
+#endif // __linux__
+
+// =======================================================
+// PUBLIC API
+// =======================================================
+// Starts reading `paths` with up to `depth` files in flight.
+// `prefer_uring` = false forces the thread-pool backend.
+static inline int batch_reader_start(BatchReader *reader, char **paths, size_t path_count,
+                                     unsigned depth, bool prefer_uring) {
+    memset(reader, 0, sizeof(BatchReader));
+    if (depth == 0) depth = BATCH_DEFAULT_QUEUE_DEPTH;
+    if (depth > BATCH_MAX_QUEUE_DEPTH) depth = BATCH_MAX_QUEUE_DEPTH;
+
+    reader->paths = paths;
+    reader->path_count = path_count;
+    reader->depth = depth;
+    reader->ready_capacity = depth;
+    reader->ready = (BatchItem *)malloc(reader->ready_capacity * sizeof(BatchItem));
+    reader->threads = (pthread_t *)malloc(depth * sizeof(pthread_t));
+    if (reader->ready == NULL || reader->threads == NULL) {
+        fprintf(stderr, "Error: Failed to allocate batch reader.\n");
+        free(reader->ready);
+        free(reader->threads);
+        return -1;
+    }
+
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->not_empty, NULL);
+    pthread_cond_init(&reader->not_full, NULL);
+
+    if (prefer_uring && batch_start_uring(reader)) {
+        reader->using_uring = true;
+        return 0;
+    }
+
+    // Fallback: `depth` blocking readers give the same number of requests in flight
+    size_t pool_size = (depth < path_count) ? depth : path_count;
+    if (pool_size == 0) pool_size = 1;
+    reader->producers_running = pool_size;
+    for (size_t t = 0; t < pool_size; t++) {
+        if (pthread_create(&reader->threads[t], NULL, batch_pool_thread_main, reader) != 0) {
+            pthread_mutex_lock(&reader->lock);
+            reader->producers_running -= pool_size - t;
+            pthread_mutex_unlock(&reader->lock);
+            if (t == 0) {
+                fprintf(stderr, "Error: Failed to start batch reader threads.\n");
+                return -1;
+            }
+            break;
+        }
+        reader->thread_count++;
+    }
+    return 0;
+}
+
+// Joins the I/O threads. Call after batch_reader_next has returned false.
+static inline void batch_reader_stop(BatchReader *reader) {
+    for (size_t t = 0; t < reader->thread_count; t++) {
+        pthread_join(reader->threads[t], NULL);
+    }
+    pthread_mutex_destroy(&reader->lock);
+    pthread_cond_destroy(&reader->not_empty);
+    pthread_cond_destroy(&reader->not_full);
+    free(reader->threads);
+    free(reader->ready);
+    reader->threads = NULL;
+    reader->ready = NULL;
+}
+
+#endif // BATCH_READER_H
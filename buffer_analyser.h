@@ -13,28 +13,33 @@
 #include <stddef.h> // For size_t
 #include <string.h> // For memset
 
-// Function to process a memory block and extract letter frequencies and word count
-// Signature changed to process buffer slice (start, length)
-static inline FrequencyData extract_frequencies_from_buffer(const wchar_t *buffer, size_t length) {
-    
-    // Initialize all fields.
-    FrequencyData data = { {0}, 0.0, 0.0, {0}, {0}, 0 }; // Initialize both hash maps to 0
-    memset(&data, 0, sizeof(FrequencyData)); // Safety memset
+// Scanner state carried between consecutive slices of the same text, so a
+// document can be counted in chunks with the same result as in one call.
+typedef struct FrequencyScan {
+    wint_t wc_prev; // Previous letter for bigram counting (L'\0' if none)
+    bool in_word;
+} FrequencyScan;
+
+static inline void frequency_scan_init(FrequencyScan *scan) {
+    scan->wc_prev = L'\0';
+    scan->in_word = false;
+}
 
+// Adds the counts of buffer[0, length) to `data`, continuing from `scan`
+static inline void accumulate_frequencies(const wchar_t *buffer, size_t length, FrequencyData *data, FrequencyScan *scan) {
+    
     wint_t wc; 
-    wint_t wc_prev = L'\0'; // Initialize previous character for bigram counting
-    bool in_word = false; 
+    wint_t wc_prev = scan->wc_prev; // Previous character for bigram counting
+    bool in_word = scan->in_word; 
 
     // Loop directly over the memory buffer up to the specified length
     for (size_t i = 0; i < length; i++) {
         wc = buffer[i];
         
         // 1. Word Counting Logic
-        bool is_word_char = iswalpha(wc) || wc == L'\'' || wc == L'-';
-
-        if (is_word_char) {
+        if (is_word_char(wc)) {
             if (!in_word) {
-                data.total_words++;
+                data->total_words++;
                 in_word = true;
             }
         } 
@@ -43,28 +48,42 @@ static inline FrequencyData extract_frequencies_from_buffer(const wchar_t *buffe
         }
 
         // 2. 40-Bin Letter Frequency Logic (for Monograph Chi-Square)
-        if (iswalpha(wc)) {
-            process_letter_frequency(wc, &data); 
+        if (is_letter(wc)) {
+            process_letter_frequency(wc, data); 
         }
 
-        // 3. BIGRAM Counting Logic (NEW)
-        if (i > 0) {
-            process_bigram_count(wc_prev, wc, &data);
-        }
+        // 3. BIGRAM Counting Logic (a non-letter wc_prev, as at the start, adds nothing)
+        process_bigram_count(wc_prev, wc, data);
 
         // 4. ALL Character Counting Logic (for Comprehensive Histogram)
         if (!iswspace(wc)) {
-            process_all_character_count(wc, &data);
+            process_all_character_count(wc, data);
         }
 
         // Update previous character for the next iteration (only track letters/hyphens/apostrophes)
         // Only track characters relevant to forming a bigram (alphabetical) for the statistical test
-        if (iswalpha(wc)) {
+        if (is_letter(wc)) {
              wc_prev = wc;
         } else {
              wc_prev = L'\0';
         }
     }
+
+    scan->wc_prev = wc_prev;
+    scan->in_word = in_word;
+}
+
+// Function to process a memory block and extract letter frequencies and word count
+// Signature changed to process buffer slice (start, length)
+static inline FrequencyData extract_frequencies_from_buffer(const wchar_t *buffer, size_t length) {
+    
+    // Initialize all fields.
+    FrequencyData data = { {0}, 0.0, 0.0, {0}, {0}, 0 }; // Initialize both hash maps to 0
+    memset(&data, 0, sizeof(FrequencyData)); // Safety memset
+
+    FrequencyScan scan;
+    frequency_scan_init(&scan);
+    accumulate_frequencies(buffer, length, &data, &scan);
     
     if (data.total_letters < 5) {
         data.error_code = 1; // Mark segment as having insufficient data
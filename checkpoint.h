@@ -0,0 +1,501 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <stdint.h> // For fixed-width fields
+#include <errno.h>
+#include <fcntl.h>  // For open
+#include <unistd.h> // For fsync
+#include <sys/stat.h>
+#include <wchar.h>
+#include "buffer_analyser.h"
+#include "freq_counter.h"
+#include "segmenter.h"
+#include "word_freq.h"
+
+// Progress of a whole-document analysis and its checkpoint file. The sliding
+// windows, the whole-document FrequencyData and the word table advance
+// together over the text, so the complete state of a run is a character
+// offset plus the aggregates below. The state is saved to a compact binary
+// file that a restarted run (--resume) loads to continue where it stopped.
+//
+// Restoring rebuilds every hash chain and word slot in its original order, so
+// the reports, including ties in the rankings, match an uninterrupted run.
+// The file is written to "<path>.tmp" and renamed over the old checkpoint, so
+// a job killed while saving still leaves the previous checkpoint intact.
+
+#define CHECKPOINT_MAGIC "TACKPT\r\n"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+#define CHECKPOINT_DEFAULT_INTERVAL 30.0 // Seconds between checkpoints
+#define CHECKPOINT_CLOCK_WINDOWS 1024   // Windows between clock reads
+#define ANALYSIS_FOLD_CHARS 65536        // Whole-document counts trail the windows by up to this
+
+typedef struct AnalysisProgress {
+    WindowScan windows;       // Window verdicts so far
+    size_t counted;           // Characters folded into `full` and `words`
+    FrequencyScan freq_scan;  // Bigram/word state at `counted`
+    FrequencyData full;       // Whole-document counts
+    WordTable words;
+} AnalysisProgress;
+
+// Identifies the input a checkpoint belongs to
+typedef struct CheckpointIdentity {
+    uint64_t file_bytes;
+    int64_t file_mtime;
+    uint64_t length;          // Decoded wide characters
+    uint32_t encoding;        // TextEncoding requested on the command line
+} CheckpointIdentity;
+
+static inline int checkpoint_identify(const char *filename, uint32_t encoding, size_t length,
+                                      CheckpointIdentity *identity) {
+    struct stat st;
+    if (stat(filename, &st) != 0) {
+        perror("Error reading file status");
+        return -1;
+    }
+    identity->file_bytes = (uint64_t)st.st_size;
+    identity->file_mtime = (int64_t)st.st_mtime;
+    identity->length = (uint64_t)length;
+    identity->encoding = encoding;
+    return 0;
+}
+
+// =======================================================
+// ANALYSIS PROGRESS
+// =======================================================
+static inline int analysis_progress_init(AnalysisProgress *progress) {
+    memset(progress, 0, sizeof(AnalysisProgress));
+    window_scan_init(&progress->windows);
+    frequency_scan_init(&progress->freq_scan);
+    return word_table_init(&progress->words);
+}
+
+static inline void analysis_progress_free(AnalysisProgress *progress) {
+    cleanup_frequency_data(&progress->full);
+    word_table_free(&progress->words);
+}
+
+// Folds buffer[counted, target) into the whole-document counts. The cut is
+// moved past a word in progress so no word is split between two calls.
+static inline void analysis_progress_advance(AnalysisProgress *progress, const wchar_t *buffer,
+                                             size_t length, size_t target) {
+    if (target > length) target = length;
+    while (target < length && is_word_char(buffer[target])) {
+        target++;
+    }
+    if (target <= progress->counted) return;
+
+    const wchar_t *slice = buffer + progress->counted;
+    size_t slice_length = target - progress->counted;
+    accumulate_frequencies(slice, slice_length, &progress->full, &progress->freq_scan);
+    count_words_in_buffer(slice, slice_length, &progress->words);
+    progress->counted = target;
+
+    // Same rule as extract_frequencies_from_buffer, on the counts so far
+    progress->full.error_code = (progress->full.total_letters < 5) ? 1 : 0;
+}
+
+// =======================================================
+// BINARY I/O (native byte order, checked on load)
+// =======================================================
+typedef struct CheckpointStream {
+    FILE *file;
+    uint64_t checksum; // FNV-1a over every byte after the magic
+    bool failed;
+} CheckpointStream;
+
+static inline void checkpoint_hash(CheckpointStream *stream, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        stream->checksum = (stream->checksum ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+static inline void checkpoint_write(CheckpointStream *stream, const void *data, size_t size) {
+    if (stream->failed) return;
+    if (fwrite(data, 1, size, stream->file) != size) {
+        stream->failed = true;
+        return;
+    }
+    checkpoint_hash(stream, data, size);
+}
+
+static inline void checkpoint_read(CheckpointStream *stream, void *data, size_t size) {
+    if (stream->failed) {
+        memset(data, 0, size);
+        return;
+    }
+    if (fread(data, 1, size, stream->file) != size) {
+        stream->failed = true;
+        memset(data, 0, size);
+        return;
+    }
+    checkpoint_hash(stream, data, size);
+}
+
+static inline void checkpoint_write_u32(CheckpointStream *stream, uint32_t value) { checkpoint_write(stream, &value, sizeof(value)); }
+static inline void checkpoint_write_u64(CheckpointStream *stream, uint64_t value) { checkpoint_write(stream, &value, sizeof(value)); }
+static inline void checkpoint_write_f64(CheckpointStream *stream, double value) { checkpoint_write(stream, &value, sizeof(value)); }
+
+static inline uint32_t checkpoint_read_u32(CheckpointStream *stream) { uint32_t value; checkpoint_read(stream, &value, sizeof(value)); return value; }
+static inline uint64_t checkpoint_read_u64(CheckpointStream *stream) { uint64_t value; checkpoint_read(stream, &value, sizeof(value)); return value; }
+static inline double checkpoint_read_f64(CheckpointStream *stream) { double value; checkpoint_read(stream, &value, sizeof(value)); return value; }
+
+// --- Header: format, build configuration and input identity ---
+static inline void checkpoint_write_header(CheckpointStream *stream, const CheckpointIdentity *identity) {
+    checkpoint_write_u32(stream, CHECKPOINT_VERSION);
+    checkpoint_write_u32(stream, CHECKPOINT_BYTE_ORDER);
+    checkpoint_write_u32(stream, (uint32_t)sizeof(wchar_t));
+    checkpoint_write_u32(stream, WINDOW_SIZE);
+    checkpoint_write_u32(stream, STEP_SIZE);
+    checkpoint_write_u32(stream, HASH_TABLE_SIZE);
+    checkpoint_write_u64(stream, identity->file_bytes);
+    checkpoint_write_u64(stream, (uint64_t)identity->file_mtime);
+    checkpoint_write_u64(stream, identity->length);
+    checkpoint_write_u32(stream, identity->encoding);
+}
+
+// Returns NULL if the header matches, otherwise the reason it does not
+static inline const char *checkpoint_check_header(CheckpointStream *stream, const CheckpointIdentity *identity) {
+    uint32_t version = checkpoint_read_u32(stream);
+    uint32_t byte_order = checkpoint_read_u32(stream);
+    uint32_t wchar_size = checkpoint_read_u32(stream);
+    uint32_t window_size = checkpoint_read_u32(stream);
+    uint32_t step_size = checkpoint_read_u32(stream);
+    uint32_t table_size = checkpoint_read_u32(stream);
+    uint64_t file_bytes = checkpoint_read_u64(stream);
+    int64_t file_mtime = (int64_t)checkpoint_read_u64(stream);
+    uint64_t length = checkpoint_read_u64(stream);
+    uint32_t encoding = checkpoint_read_u32(stream);
+
+    if (stream->failed) return "truncated header";
+    if (version != CHECKPOINT_VERSION) return "unsupported checkpoint version";
+    if (byte_order != CHECKPOINT_BYTE_ORDER || wchar_size != sizeof(wchar_t)) return "written on a different platform";
+    if (window_size != WINDOW_SIZE || step_size != STEP_SIZE || table_size != HASH_TABLE_SIZE) {
+        return "written by a build with a different window configuration";
+    }
+    if (file_bytes != identity->file_bytes || file_mtime != identity->file_mtime) return "the input file has changed";
+    if (length != identity->length || encoding != identity->encoding) return "the input was decoded differently";
+    return NULL;
+}
+
+// --- Chained maps: non-empty buckets, each chain head first ---
+static inline void checkpoint_write_char_map(CheckpointStream *stream, const CharMap *map) {
+    uint32_t buckets = 0;
+    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
+        if (map->table[i] != NULL) buckets++;
+    }
+    checkpoint_write_u32(stream, (uint32_t)map->total_unique_chars);
+    checkpoint_write_u32(stream, buckets);
+
+    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
+        if (map->table[i] == NULL) continue;
+        uint32_t chain = 0;
+        for (const CharMapNode *node = map->table[i]; node != NULL; node = node->next) chain++;
+        checkpoint_write_u32(stream, (uint32_t)i);
+        checkpoint_write_u32(stream, chain);
+        for (const CharMapNode *node = map->table[i]; node != NULL; node = node->next) {
+            checkpoint_write_u32(stream, (uint32_t)node->character);
+            checkpoint_write_f64(stream, node->count);
+        }
+    }
+}
+
+static inline void checkpoint_write_bigram_map(CheckpointStream *stream, const BigramMap *map) {
+    uint32_t buckets = 0;
+    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
+        if (map->table[i] != NULL) buckets++;
+    }
+    checkpoint_write_u32(stream, (uint32_t)map->total_unique_bigrams);
+    checkpoint_write_f64(stream, map->total_bigrams);
+    checkpoint_write_u32(stream, buckets);
+
+    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
+        if (map->table[i] == NULL) continue;
+        uint32_t chain = 0;
+        for (const BigramNode *node = map->table[i]; node != NULL; node = node->next) chain++;
+        checkpoint_write_u32(stream, (uint32_t)i);
+        checkpoint_write_u32(stream, chain);
+        for (const BigramNode *node = map->table[i]; node != NULL; node = node->next) {
+            checkpoint_write_u32(stream, node->key);
+            checkpoint_write_f64(stream, node->count);
+        }
+    }
+}
+
+// Chains are rebuilt by appending at the tail, keeping the saved order
+static inline int checkpoint_read_char_map(CheckpointStream *stream, CharMap *map) {
+    map->total_unique_chars = (int)checkpoint_read_u32(stream);
+    uint32_t buckets = checkpoint_read_u32(stream);
+
+    for (uint32_t b = 0; b < buckets && !stream->failed; b++) {
+        uint32_t index = checkpoint_read_u32(stream);
+        uint32_t chain = checkpoint_read_u32(stream);
+        if (index >= HASH_TABLE_SIZE || map->table[index] != NULL) return -1;
+
+        CharMapNode **tail = &map->table[index];
+        for (uint32_t k = 0; k < chain && !stream->failed; k++) {
+            CharMapNode *node = (CharMapNode *)malloc(sizeof(CharMapNode));
+            if (node == NULL) return -1;
+            node->character = (wint_t)checkpoint_read_u32(stream);
+            node->count = checkpoint_read_f64(stream);
+            node->next = NULL;
+            *tail = node;
+            tail = &node->next;
+        }
+    }
+    return stream->failed ? -1 : 0;
+}
+
+static inline int checkpoint_read_bigram_map(CheckpointStream *stream, BigramMap *map) {
+    map->total_unique_bigrams = (int)checkpoint_read_u32(stream);
+    map->total_bigrams = checkpoint_read_f64(stream);
+    uint32_t buckets = checkpoint_read_u32(stream);
+
+    for (uint32_t b = 0; b < buckets && !stream->failed; b++) {
+        uint32_t index = checkpoint_read_u32(stream);
+        uint32_t chain = checkpoint_read_u32(stream);
+        if (index >= HASH_TABLE_SIZE || map->table[index] != NULL) return -1;
+
+        BigramNode **tail = &map->table[index];
+        for (uint32_t k = 0; k < chain && !stream->failed; k++) {
+            BigramNode *node = (BigramNode *)malloc(sizeof(BigramNode));
+            if (node == NULL) return -1;
+            node->key = checkpoint_read_u32(stream);
+            node->count = checkpoint_read_f64(stream);
+            node->next = NULL;
+            *tail = node;
+            tail = &node->next;
+        }
+    }
+    return stream->failed ? -1 : 0;
+}
+
+// --- Word table: every live slot at its original index ---
+static inline void checkpoint_write_words(CheckpointStream *stream, const WordTable *table) {
+    checkpoint_write_u64(stream, (uint64_t)table->capacity);
+    checkpoint_write_u64(stream, (uint64_t)table->unique_words);
+    checkpoint_write_f64(stream, table->total_words);
+    for (int i = 0; i <= MAX_WORD_LENGTH_BIN; i++) {
+        checkpoint_write_f64(stream, table->length_freq[i]);
+    }
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        const WordEntry *slot = &table->slots[i];
+        if (!word_slot_live(table, slot)) continue;
+        checkpoint_write_u64(stream, (uint64_t)i);
+        checkpoint_write_u32(stream, slot->length);
+        checkpoint_write_u32(stream, slot->hash);
+        checkpoint_write_f64(stream, slot->count);
+        for (uint32_t k = 0; k < slot->length; k++) {
+            checkpoint_write_u32(stream, (uint32_t)slot->word[k]);
+        }
+    }
+}
+
+// `max_length` (the input length) bounds every size read before the checksum is verified
+static inline int checkpoint_read_words(CheckpointStream *stream, WordTable *table, uint64_t max_length) {
+    uint64_t capacity = checkpoint_read_u64(stream);
+    uint64_t unique_words = checkpoint_read_u64(stream);
+    double total_words = checkpoint_read_f64(stream);
+    double length_freq[MAX_WORD_LENGTH_BIN + 1];
+    for (int i = 0; i <= MAX_WORD_LENGTH_BIN; i++) {
+        length_freq[i] = checkpoint_read_f64(stream);
+    }
+    if (stream->failed || capacity < WORD_TABLE_INITIAL_CAPACITY || (capacity & (capacity - 1)) != 0 ||
+        unique_words >= capacity || capacity > 4 * max_length + WORD_TABLE_INITIAL_CAPACITY) {
+        return -1;
+    }
+
+    WordEntry *slots = (WordEntry *)calloc((size_t)capacity, sizeof(WordEntry));
+    if (slots == NULL) return -1;
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = (size_t)capacity;
+
+    for (uint64_t w = 0; w < unique_words; w++) {
+        uint64_t index = checkpoint_read_u64(stream);
+        uint32_t length = checkpoint_read_u32(stream);
+        uint32_t hash = checkpoint_read_u32(stream);
+        double count = checkpoint_read_f64(stream);
+        if (stream->failed || index >= capacity || length > max_length || word_slot_live(table, &slots[index])) {
+            return -1;
+        }
+
+        wchar_t *text = word_arena_alloc(&table->arena, (size_t)length + 1);
+        if (text == NULL) return -1;
+        for (uint32_t k = 0; k < length; k++) {
+            text[k] = (wchar_t)checkpoint_read_u32(stream);
+        }
+        text[length] = L'\0';
+
+        WordEntry *slot = &slots[index];
+        slot->word = text;
+        slot->length = length;
+        slot->hash = hash;
+        slot->generation = table->generation;
+        slot->count = count;
+    }
+
+    table->unique_words = (size_t)unique_words;
+    table->total_words = total_words;
+    memcpy(table->length_freq, length_freq, sizeof(length_freq));
+    return stream->failed ? -1 : 0;
+}
+
+// =======================================================
+// SAVE / LOAD
+// =======================================================
+// Returns 0 on success, -1 (with a message) on failure.
+// Flushes the directory entry of `path` (its rename) to disk. Filesystems that
+// cannot sync a directory (EINVAL) are not an error.
+static inline int checkpoint_sync_directory(const char *path) {
+    const char *slash = strrchr(path, '/');
+    char *dir_path = NULL;
+    if (slash != NULL) {
+        size_t dir_length = (slash == path) ? 1 : (size_t)(slash - path); // "/name" lives in "/"
+        dir_path = (char *)malloc(dir_length + 1);
+        if (dir_path == NULL) return -1;
+        memcpy(dir_path, path, dir_length);
+        dir_path[dir_length] = '\0';
+    }
+
+    int fd = open((dir_path != NULL) ? dir_path : ".", O_RDONLY);
+    free(dir_path);
+    if (fd < 0) return -1;
+    int status = (fsync(fd) != 0 && errno != EINVAL) ? -1 : 0;
+    close(fd);
+    return status;
+}
+
+static inline int checkpoint_save(const char *path, const CheckpointIdentity *identity,
+                                  const AnalysisProgress *progress) {
+    size_t path_length = strlen(path);
+    char *temp_path = (char *)malloc(path_length + 5);
+    if (temp_path == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the checkpoint path.\n");
+        return -1;
+    }
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, ".tmp", 5);
+
+    CheckpointStream stream = { fopen(temp_path, "wb"), 14695981039346656037ull, false };
+    if (stream.file == NULL) {
+        perror("Error writing checkpoint");
+        free(temp_path);
+        return -1;
+    }
+
+    fwrite(CHECKPOINT_MAGIC, 1, 8, stream.file);
+    checkpoint_write_header(&stream, identity);
+
+    const WindowScan *windows = &progress->windows;
+    checkpoint_write_u64(&stream, windows->position);
+    checkpoint_write_u64(&stream, windows->eng_chars);
+    checkpoint_write_u64(&stream, windows->fre_chars);
+    checkpoint_write_u32(&stream, windows->finished ? 1 : 0);
+    checkpoint_write_u64(&stream, progress->counted);
+    checkpoint_write_u32(&stream, (uint32_t)progress->freq_scan.wc_prev);
+    checkpoint_write_u32(&stream, progress->freq_scan.in_word ? 1 : 0);
+
+    const FrequencyData *full = &progress->full;
+    for (int i = 0; i < TOTAL_BINS; i++) {
+        checkpoint_write_f64(&stream, full->observed_freq[i]);
+    }
+    checkpoint_write_f64(&stream, full->total_letters);
+    checkpoint_write_f64(&stream, full->total_words);
+    checkpoint_write_char_map(&stream, &full->all_char_map);
+    checkpoint_write_bigram_map(&stream, &full->bigram_map);
+    checkpoint_write_words(&stream, &progress->words);
+
+    uint64_t checksum = stream.checksum;
+    checkpoint_write_u64(&stream, checksum);
+
+    // The data reaches the disk before the rename makes it the checkpoint, and
+    // the rename itself before the save counts as done, so a crash leaves
+    // either the old checkpoint or the new one
+    bool failed = stream.failed;
+    if (fflush(stream.file) != 0) failed = true;
+    if (!failed && fsync(fileno(stream.file)) != 0) failed = true;
+    if (fclose(stream.file) != 0) failed = true;
+    if (!failed && rename(temp_path, path) != 0) failed = true;
+
+    if (failed) {
+        perror("Error writing checkpoint");
+        remove(temp_path);
+    } else if (checkpoint_sync_directory(path) != 0) {
+        perror("Error syncing checkpoint directory");
+        failed = true;
+    }
+    free(temp_path);
+    return failed ? -1 : 0;
+}
+
+// Loads a checkpoint into a freshly initialised `progress`. Returns 0 on
+// success, 1 if there is no checkpoint yet (nothing loaded), or -1 (with a
+// message) if it is damaged or belongs to another input; `progress` must then
+// be freed.
+static inline int checkpoint_load(const char *path, const CheckpointIdentity *identity,
+                                  AnalysisProgress *progress) {
+    CheckpointStream stream = { fopen(path, "rb"), 14695981039346656037ull, false };
+    if (stream.file == NULL) {
+        if (errno == ENOENT) return 1;
+        perror("Error opening checkpoint");
+        return -1;
+    }
+
+    char magic[8];
+    const char *problem = NULL;
+    if (fread(magic, 1, sizeof(magic), stream.file) != sizeof(magic) || memcmp(magic, CHECKPOINT_MAGIC, 8) != 0) {
+        problem = "not a checkpoint file";
+    } else {
+        problem = checkpoint_check_header(&stream, identity);
+    }
+
+    if (problem == NULL) {
+        WindowScan *windows = &progress->windows;
+        windows->position = (size_t)checkpoint_read_u64(&stream);
+        windows->eng_chars = (size_t)checkpoint_read_u64(&stream);
+        windows->fre_chars = (size_t)checkpoint_read_u64(&stream);
+        windows->finished = checkpoint_read_u32(&stream) != 0;
+        progress->counted = (size_t)checkpoint_read_u64(&stream);
+        progress->freq_scan.wc_prev = (wint_t)checkpoint_read_u32(&stream);
+        progress->freq_scan.in_word = checkpoint_read_u32(&stream) != 0;
+
+        FrequencyData *full = &progress->full;
+        for (int i = 0; i < TOTAL_BINS; i++) {
+            full->observed_freq[i] = checkpoint_read_f64(&stream);
+        }
+        full->total_letters = checkpoint_read_f64(&stream);
+        full->total_words = checkpoint_read_f64(&stream);
+        full->error_code = (full->total_letters < 5) ? 1 : 0;
+
+        if (checkpoint_read_char_map(&stream, &full->all_char_map) != 0 ||
+            checkpoint_read_bigram_map(&stream, &full->bigram_map) != 0 ||
+            checkpoint_read_words(&stream, &progress->words, identity->length) != 0) {
+            problem = "damaged or truncated";
+        } else {
+            uint64_t expected = stream.checksum;
+            uint64_t stored = checkpoint_read_u64(&stream);
+            if (stream.failed || stored != expected) {
+                problem = "checksum mismatch";
+            } else if (progress->counted > identity->length || windows->position > identity->length + STEP_SIZE) {
+                problem = "offsets beyond the end of the input";
+            }
+        }
+    }
+    fclose(stream.file);
+
+    if (problem != NULL) {
+        fprintf(stderr, "Error: Cannot resume from checkpoint '%s': %s.\n", path, problem);
+        return -1;
+    }
+    return 0;
+}
+
+#endif // CHECKPOINT_H
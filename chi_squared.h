@@ -9,6 +9,7 @@
 #include <stddef.h> // For size_t
 #include <stdint.h> // For uint32_t
 #include <wchar.h> // For wint_t
+#include <pthread.h> // For score_table_lock
 
 // Language IDs to be returned
 #define LANG_ENG 0
@@ -71,43 +72,151 @@ static const BigramRef FRENCH_BIGRAM_FREQ[TOP_BIGRAMS] = {
     {MAKE_BIGRAM_KEY('e','t'), 1.44}, {MAKE_BIGRAM_KEY('v','o'), 1.41}
 };
 
-// --- Bigram Chi-Squared Calculation ---
-static inline double calculate_bigram_chi(const BigramMap *map, const BigramRef *ref_freq) {
-    if (map->total_bigrams < EPS) {
-        return 99999.0; // Return a huge score if no bigrams were found
+// =======================================================
+// PRECOMPUTED SCORING TABLES
+// =======================================================
+// Expected counts only depend on the reference frequencies and on the letter
+// (or bigram) total, and nearly every window has a total below WINDOW_SIZE.
+// The table for such a total is built the first time a sample has it (only a
+// few distinct totals occur in practice), so scoring a window is a single
+// multiply-add loop with no divisions and nothing is built before the input
+// needs it. English and French are interleaved ([bin][lang]) so both languages
+// are scored in the same pass and each lane keeps the exact summation order of
+// the original formula.
+
+#define SCORE_TABLE_MAX_TOTAL 512 // Totals below this are cached (covers WINDOW_SIZE)
+#define BIGRAM_WEIGHT 0.20        // Bigram score weight relative to the monograph score
+#define NO_BIGRAM_SCORE 99999.0   // Score when a sample contains no bigrams
+
+typedef struct MonographScoreTable {
+    double expected[TOTAL_BINS][2]; // [bin][LANG_ENG / LANG_FRE]
+    double recip[TOTAL_BINS][2];    // 1 / (expected + EPS)
+} MonographScoreTable;
+
+typedef struct BigramScoreTable {
+    double expected[TOP_BIGRAMS][2];
+    double recip[TOP_BIGRAMS][2];
+} BigramScoreTable;
+
+static MonographScoreTable MONOGRAPH_TABLES[SCORE_TABLE_MAX_TOTAL];
+static BigramScoreTable BIGRAM_TABLES[SCORE_TABLE_MAX_TOTAL];
+static unsigned char MONOGRAPH_TABLE_READY[SCORE_TABLE_MAX_TOTAL];
+static unsigned char BIGRAM_TABLE_READY[SCORE_TABLE_MAX_TOTAL];
+static pthread_mutex_t score_table_lock = PTHREAD_MUTEX_INITIALIZER; // Serialises first builds
+
+static inline void build_monograph_table(MonographScoreTable *table, double total_letters) {
+    double total_letters_pct = total_letters / 100.0;
+    for (int i = 0; i < TOTAL_BINS; i++) {
+        table->expected[i][LANG_ENG] = ENGLISH_FREQ[i] * total_letters_pct;
+        table->expected[i][LANG_FRE] = FRENCH_FREQ[i] * total_letters_pct;
+        table->recip[i][LANG_ENG] = 1.0 / (table->expected[i][LANG_ENG] + EPS);
+        table->recip[i][LANG_FRE] = 1.0 / (table->expected[i][LANG_FRE] + EPS);
     }
+}
 
-    double chi = 0.0;
-    double total_bigrams = map->total_bigrams;
-    
-    // Iterate through the top reference bigrams
+static inline void build_bigram_table(BigramScoreTable *table, double total_bigrams) {
     for (int i = 0; i < TOP_BIGRAMS; i++) {
-        uint32_t ref_key = ref_freq[i].key;
-        double ref_pct = ref_freq[i].freq;
-        
-        // 1. Find the observed count for this bigram in the input text
-        unsigned int index = hash_key(ref_key);
-        const BigramNode *current = map->table[index];
-        double observed_count = 0.0;
-        
-        while (current != NULL) {
-            if (current->key == ref_key) {
-                observed_count = current->count;
-                break;
-            }
-            current = current->next;
+        table->expected[i][LANG_ENG] = (ENGLISH_BIGRAM_FREQ[i].freq / 100.0) * total_bigrams;
+        table->expected[i][LANG_FRE] = (FRENCH_BIGRAM_FREQ[i].freq / 100.0) * total_bigrams;
+        table->recip[i][LANG_ENG] = 1.0 / (table->expected[i][LANG_ENG] + EPS);
+        table->recip[i][LANG_FRE] = 1.0 / (table->expected[i][LANG_FRE] + EPS);
+    }
+}
+
+// Cached table for a total below SCORE_TABLE_MAX_TOTAL; safe from any thread
+static inline const MonographScoreTable *monograph_table_for(int total) {
+    if (!__atomic_load_n(&MONOGRAPH_TABLE_READY[total], __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&score_table_lock);
+        if (!MONOGRAPH_TABLE_READY[total]) {
+            build_monograph_table(&MONOGRAPH_TABLES[total], (double)total);
+            __atomic_store_n(&MONOGRAPH_TABLE_READY[total], 1, __ATOMIC_RELEASE);
         }
+        pthread_mutex_unlock(&score_table_lock);
+    }
+    return &MONOGRAPH_TABLES[total];
+}
 
-        // 2. Calculate Expected Count
-        double expected_count = (ref_pct / 100.0) * total_bigrams;
+static inline const BigramScoreTable *bigram_table_for(int total) {
+    if (!__atomic_load_n(&BIGRAM_TABLE_READY[total], __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&score_table_lock);
+        if (!BIGRAM_TABLE_READY[total]) {
+            build_bigram_table(&BIGRAM_TABLES[total], (double)total);
+            __atomic_store_n(&BIGRAM_TABLE_READY[total], 1, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&score_table_lock);
+    }
+    return &BIGRAM_TABLES[total];
+}
 
-        // 3. Chi-Squared formula (adding a small EPS to the denominator)
-        double diff = observed_count - expected_count;
-        chi += (diff * diff) / (expected_count + EPS);
+// Observed count of one bigram in the map (0 if absent)
+static inline double lookup_bigram_count(const BigramMap *map, uint32_t key) {
+    const BigramNode *current = map->table[hash_key(key)];
+    while (current != NULL) {
+        if (current->key == key) {
+            return current->count;
+        }
+        current = current->next;
     }
-    
-    // Weight the bigram score less than the monograph score (e.g., 20% weight)
-    return chi * 0.20; 
+    return 0.0;
+}
+
+// --- Monograph Chi-Squared for both languages (chi[LANG_ENG], chi[LANG_FRE]) ---
+static inline void score_monograph(const FrequencyData *data, double chi[2]) {
+    MonographScoreTable local;
+    const MonographScoreTable *table;
+
+    double total = data->total_letters;
+    if (total < SCORE_TABLE_MAX_TOTAL) {
+        table = monograph_table_for((int)total);
+    } else {
+        build_monograph_table(&local, total); // Whole-document totals
+        table = &local;
+    }
+
+    double chi_eng = 0.0;
+    double chi_fre = 0.0;
+    for (int i = 0; i < TOTAL_BINS; i++) {
+        double observed = data->observed_freq[i];
+        double diff_eng = observed - table->expected[i][LANG_ENG];
+        double diff_fre = observed - table->expected[i][LANG_FRE];
+        chi_eng += (diff_eng * diff_eng) * table->recip[i][LANG_ENG];
+        chi_fre += (diff_fre * diff_fre) * table->recip[i][LANG_FRE];
+    }
+    chi[LANG_ENG] = chi_eng;
+    chi[LANG_FRE] = chi_fre;
+}
+
+// --- Bigram Chi-Squared for both languages (already weighted) ---
+static inline void score_bigrams(const BigramMap *map, double chi[2]) {
+    if (map->total_bigrams < EPS) {
+        chi[LANG_ENG] = NO_BIGRAM_SCORE; // Return a huge score if no bigrams were found
+        chi[LANG_FRE] = NO_BIGRAM_SCORE;
+        return;
+    }
+
+    BigramScoreTable local;
+    const BigramScoreTable *table;
+
+    double total = map->total_bigrams;
+    if (total < SCORE_TABLE_MAX_TOTAL) {
+        table = bigram_table_for((int)total);
+    } else {
+        build_bigram_table(&local, total);
+        table = &local;
+    }
+
+    double chi_eng = 0.0;
+    double chi_fre = 0.0;
+    for (int i = 0; i < TOP_BIGRAMS; i++) {
+        double diff_eng = lookup_bigram_count(map, ENGLISH_BIGRAM_FREQ[i].key) - table->expected[i][LANG_ENG];
+        double diff_fre = lookup_bigram_count(map, FRENCH_BIGRAM_FREQ[i].key) - table->expected[i][LANG_FRE];
+        chi_eng += (diff_eng * diff_eng) * table->recip[i][LANG_ENG];
+        chi_fre += (diff_fre * diff_fre) * table->recip[i][LANG_FRE];
+    }
+
+    // Weight the bigram score less than the monograph score
+    chi[LANG_ENG] = chi_eng * BIGRAM_WEIGHT;
+    chi[LANG_FRE] = chi_fre * BIGRAM_WEIGHT;
 }
 
 
@@ -118,60 +227,32 @@ int perform_segment_test(const FrequencyData *data) {
         return LANG_ERROR; 
     }
 
-    // --- 1. Monograph (Single-Letter) Chi-Squared ---
-    double chi1_mono = 0.0; // English Chi-Squared
-    double chi2_mono = 0.0; // French Chi-Squared
-    double total_letters_pct = data->total_letters / 100.0; // Scaling factor
+    double chi_mono[2];
+    double chi_bigram[2];
+    score_monograph(data, chi_mono);
+    score_bigrams(&data->bigram_map, chi_bigram);
 
-    for (int i = 0; i < TOTAL_BINS; i++) {
-        double expected_eng = ENGLISH_FREQ[i] * total_letters_pct;
-        double expected_french = FRENCH_FREQ[i] * total_letters_pct;
-        
-        double diff1 = data->observed_freq[i] - expected_eng;
-        chi1_mono += (diff1 * diff1) / (expected_eng + EPS); 
-        
-        double diff2 = data->observed_freq[i] - expected_french;
-        chi2_mono += (diff2 * diff2) / (expected_french + EPS); 
-    }
-    
-    // --- 2. Bigram (Two-Letter) Chi-Squared (NEW) ---
-    double chi1_bigram = calculate_bigram_chi(&data->bigram_map, ENGLISH_BIGRAM_FREQ);
-    double chi2_bigram = calculate_bigram_chi(&data->bigram_map, FRENCH_BIGRAM_FREQ);
-
-    // --- 3. Combined Final Score ---
     // Total score is the sum of Monograph and Bigram scores.
-    double chi1_final = chi1_mono + chi1_bigram;
-    double chi2_final = chi2_mono + chi2_bigram;
+    double chi1_final = chi_mono[LANG_ENG] + chi_bigram[LANG_ENG];
+    double chi2_final = chi_mono[LANG_FRE] + chi_bigram[LANG_FRE];
 
-    if (chi1_final < chi2_final) {
-        return LANG_ENG;
-    } else {
-        return LANG_FRE;
-    }
+    return (chi1_final < chi2_final) ? LANG_ENG : LANG_FRE;
 }
 
 // --- Final Analysis Function (Updated to report both scores) ---
 void perform_final_analysis(const FrequencyData *data, size_t eng_chars, size_t fre_chars) {
     
     // --- 1. Monograph (Single-Letter) Chi-Squared ---
-    double chi1_mono = 0.0;
-    double chi2_mono = 0.0;
-    double total_letters_pct = data->total_letters / 100.0;
-
-    for (int i = 0; i < TOTAL_BINS; i++) {
-        double expected_eng = ENGLISH_FREQ[i] * total_letters_pct;
-        double expected_french = FRENCH_FREQ[i] * total_letters_pct;
-        
-        double diff1 = data->observed_freq[i] - expected_eng;
-        chi1_mono += (diff1 * diff1) / (expected_eng + EPS); 
-        
-        double diff2 = data->observed_freq[i] - expected_french;
-        chi2_mono += (diff2 * diff2) / (expected_french + EPS); 
-    }
+    double chi_mono[2];
+    score_monograph(data, chi_mono);
+    double chi1_mono = chi_mono[LANG_ENG];
+    double chi2_mono = chi_mono[LANG_FRE];
     
     // --- 2. Bigram (Two-Letter) Chi-Squared (NEW) ---
-    double chi1_bigram = calculate_bigram_chi(&data->bigram_map, ENGLISH_BIGRAM_FREQ);
-    double chi2_bigram = calculate_bigram_chi(&data->bigram_map, FRENCH_BIGRAM_FREQ);
+    double chi_bigram[2];
+    score_bigrams(&data->bigram_map, chi_bigram);
+    double chi1_bigram = chi_bigram[LANG_ENG];
+    double chi2_bigram = chi_bigram[LANG_FRE];
     
     // --- 3. Combined Final Score ---
     double chi1_final = chi1_mono + chi1_bigram;
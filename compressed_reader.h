@@ -0,0 +1,425 @@
+#ifndef COMPRESSED_READER_H
+#define COMPRESSED_READER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include "text_decoder.h"
+
+// Native reading of gzip- and zstd-compressed input. Decompression runs on its
+// own thread and hands fixed-size blocks of decoded bytes to the caller through
+// a bounded queue. While the next block is inflated the caller decodes the
+// previous one to wide characters and offers it to its DecodeSink, which can
+// analyse the text as it arrives. No temporary file is written.
+//
+// Codecs are opt-in at build time:
+//   -DTA_WITH_ZLIB  (link with -lz)     enables gzip
+//   -DTA_WITH_ZSTD  (link with -lzstd)  enables zstd
+// Either one also needs -pthread.
+
+#define DECODE_BLOCK_SIZE (256 * 1024) // Decompressed bytes per queue block
+#define DECODE_FIRST_BLOCK_SIZE (16 * 1024) // Blocks double from here, so the first text arrives early
+#define DECODE_QUEUE_DEPTH 4           // Blocks in flight between the two threads
+#define COMPRESSED_READ_SIZE (64 * 1024)
+
+typedef enum {
+    INPUT_PLAIN = 0,
+    INPUT_GZIP,
+    INPUT_ZSTD
+} InputFormat;
+
+static inline void report_unsupported_format(InputFormat format) {
+    fprintf(stderr, "Error: %s input is not supported by this build (rebuild with %s).\n",
+            (format == INPUT_GZIP) ? "gzip" : "zstd",
+            (format == INPUT_GZIP) ? "-DTA_WITH_ZLIB -lz" : "-DTA_WITH_ZSTD -lzstd");
+}
+
+// Identifies the container from the first bytes of the file
+static inline InputFormat detect_input_format(const unsigned char *magic, size_t length) {
+    if (length >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+        return INPUT_GZIP;
+    }
+    if (length >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+        return INPUT_ZSTD;
+    }
+    return INPUT_PLAIN;
+}
+
+#if defined(TA_WITH_ZLIB) || defined(TA_WITH_ZSTD)
+
+#include <pthread.h>
+
+#ifdef TA_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef TA_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+// =======================================================
+// BOUNDED BLOCK QUEUE (one producer, one consumer)
+// =======================================================
+typedef struct DecodeBlock {
+    unsigned char *data;
+    size_t length;
+    long input_consumed; // Compressed bytes consumed once this block was filled
+} DecodeBlock;
+
+typedef struct DecodeQueue {
+    DecodeBlock blocks[DECODE_QUEUE_DEPTH];
+    size_t head;  // Oldest filled block
+    size_t count; // Filled blocks, including the one the consumer is working on
+    bool done;      // Producer finished (check `error` for the reason)
+    bool cancelled; // Consumer gave up; producer should stop
+    int error;
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} DecodeQueue;
+
+// =======================================================
+// DECOMPRESSOR (runs on the producer thread)
+// =======================================================
+typedef struct Decompressor {
+    InputFormat format;
+    FILE *input;
+    unsigned char in_buf[COMPRESSED_READ_SIZE];
+    bool input_eof;
+#ifdef TA_WITH_ZLIB
+    z_stream zs;
+#endif
+#ifdef TA_WITH_ZSTD
+    ZSTD_DCtx *dctx;
+    ZSTD_inBuffer zin;
+#endif
+} Decompressor;
+
+#ifdef TA_WITH_ZLIB
+// Reads the next chunk of compressed input into `in_buf`. Returns the bytes read;
+// 0 means the input is exhausted.
+static inline size_t decompressor_read(Decompressor *dec) {
+    size_t n = fread(dec->in_buf, 1, COMPRESSED_READ_SIZE, dec->input);
+    if (n < COMPRESSED_READ_SIZE) dec->input_eof = true;
+    dec->zs.next_in = dec->in_buf;
+    dec->zs.avail_in = (uInt)n;
+    return n;
+}
+
+// Called at the end of a gzip member: true when another member follows.
+// Zero bytes after a member are padding (as written by tape and block devices)
+// and end the input like EOF does. The input may end exactly on a read boundary,
+// so an empty buffer is refilled before deciding.
+static inline bool gzip_member_follows(Decompressor *dec) {
+    for (;;) {
+        while (dec->zs.avail_in > 0 && *dec->zs.next_in == 0) {
+            dec->zs.next_in++;
+            dec->zs.avail_in--;
+        }
+        if (dec->zs.avail_in > 0) {
+            return true;
+        }
+        if (dec->input_eof || decompressor_read(dec) == 0) {
+            return false;
+        }
+    }
+}
+#endif
+
+// Fills `out` with up to `capacity` decompressed bytes.
+// Returns 0 while more data may follow, 1 at end of stream, -1 on error.
+static inline int decompressor_fill(Decompressor *dec, unsigned char *out, size_t capacity, size_t *produced) {
+    *produced = 0;
+
+#ifdef TA_WITH_ZLIB
+    if (dec->format == INPUT_GZIP) {
+        dec->zs.next_out = out;
+        dec->zs.avail_out = (uInt)capacity;
+
+        while (dec->zs.avail_out > 0) {
+            if (dec->zs.avail_in == 0 && !dec->input_eof) {
+                decompressor_read(dec);
+            }
+
+            int ret = inflate(&dec->zs, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                // Concatenated gzip members are decoded as one stream
+                if (!gzip_member_follows(dec)) {
+                    *produced = capacity - dec->zs.avail_out;
+                    return 1;
+                }
+                inflateReset(&dec->zs);
+            } else if (ret == Z_BUF_ERROR && dec->zs.avail_in == 0 && dec->input_eof) {
+                fprintf(stderr, "Error: Truncated gzip input.\n");
+                return -1;
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                fprintf(stderr, "Error: gzip decompression failed (%s).\n", dec->zs.msg ? dec->zs.msg : "unknown");
+                return -1;
+            }
+        }
+        *produced = capacity;
+        return 0;
+    }
+#endif
+
+#ifdef TA_WITH_ZSTD
+    if (dec->format == INPUT_ZSTD) {
+        ZSTD_outBuffer zout = { out, capacity, 0 };
+        size_t last_ret = 0;
+
+        while (zout.pos < zout.size) {
+            if (dec->zin.pos == dec->zin.size) {
+                if (dec->input_eof) {
+                    *produced = zout.pos;
+                    if (last_ret != 0) {
+                        fprintf(stderr, "Error: Truncated zstd input.\n");
+                        return -1;
+                    }
+                    return 1;
+                }
+                size_t n = fread(dec->in_buf, 1, COMPRESSED_READ_SIZE, dec->input);
+                if (n < COMPRESSED_READ_SIZE) dec->input_eof = true;
+                dec->zin.src = dec->in_buf;
+                dec->zin.size = n;
+                dec->zin.pos = 0;
+            }
+
+            last_ret = ZSTD_decompressStream(dec->dctx, &zout, &dec->zin);
+            if (ZSTD_isError(last_ret)) {
+                fprintf(stderr, "Error: zstd decompression failed (%s).\n", ZSTD_getErrorName(last_ret));
+                return -1;
+            }
+        }
+        *produced = zout.pos;
+        return 0;
+    }
+#endif
+
+    (void)out;
+    (void)capacity;
+    return -1;
+}
+
+static inline int decompressor_init(Decompressor *dec, InputFormat format, FILE *input) {
+    memset(dec, 0, sizeof(Decompressor));
+    dec->format = format;
+    dec->input = input;
+
+#ifdef TA_WITH_ZLIB
+    if (format == INPUT_GZIP) {
+        // 15 + 32: maximum window, auto-detect the gzip/zlib header
+        return (inflateInit2(&dec->zs, 15 + 32) == Z_OK) ? 0 : -1;
+    }
+#endif
+#ifdef TA_WITH_ZSTD
+    if (format == INPUT_ZSTD) {
+        dec->dctx = ZSTD_createDCtx();
+        return (dec->dctx != NULL) ? 0 : -1;
+    }
+#endif
+    report_unsupported_format(format);
+    return -1;
+}
+
+// Compressed bytes consumed so far (read from the file and not still buffered)
+static inline long decompressor_consumed(const Decompressor *dec) {
+    long position = ftell(dec->input);
+#ifdef TA_WITH_ZLIB
+    if (dec->format == INPUT_GZIP) position -= (long)dec->zs.avail_in;
+#endif
+#ifdef TA_WITH_ZSTD
+    if (dec->format == INPUT_ZSTD) position -= (long)(dec->zin.size - dec->zin.pos);
+#endif
+    return position;
+}
+
+static inline void decompressor_free(Decompressor *dec) {
+#ifdef TA_WITH_ZLIB
+    if (dec->format == INPUT_GZIP) inflateEnd(&dec->zs);
+#endif
+#ifdef TA_WITH_ZSTD
+    if (dec->format == INPUT_ZSTD) ZSTD_freeDCtx(dec->dctx);
+#endif
+    (void)dec;
+}
+
+typedef struct DecompressJob {
+    Decompressor dec;
+    DecodeQueue queue;
+} DecompressJob;
+
+static void *decompress_thread_main(void *arg) {
+    DecompressJob *job = (DecompressJob *)arg;
+    DecodeQueue *q = &job->queue;
+    int status = 0;
+    size_t fill_size = DECODE_FIRST_BLOCK_SIZE;
+
+    while (status == 0) {
+        // 1. Wait for a free block
+        pthread_mutex_lock(&q->lock);
+        while (q->count == DECODE_QUEUE_DEPTH && !q->cancelled) {
+            pthread_cond_wait(&q->not_full, &q->lock);
+        }
+        if (q->cancelled) {
+            pthread_mutex_unlock(&q->lock);
+            break;
+        }
+        DecodeBlock *block = &q->blocks[(q->head + q->count) % DECODE_QUEUE_DEPTH];
+        pthread_mutex_unlock(&q->lock);
+
+        // 2. Decompress into it without holding the lock
+        status = decompressor_fill(&job->dec, block->data, fill_size, &block->length);
+        block->input_consumed = decompressor_consumed(&job->dec);
+        fill_size = (fill_size * 2 < DECODE_BLOCK_SIZE) ? fill_size * 2 : DECODE_BLOCK_SIZE;
+
+        // 3. Publish it
+        pthread_mutex_lock(&q->lock);
+        if (status >= 0 && block->length > 0) {
+            q->count++;
+            pthread_cond_signal(&q->not_empty);
+        }
+        pthread_mutex_unlock(&q->lock);
+    }
+
+    pthread_mutex_lock(&q->lock);
+    q->done = true;
+    q->error = (status < 0) ? 1 : 0;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+    return NULL;
+}
+
+// =======================================================
+// CONSUMER: decoded blocks -> wide character buffer
+// =======================================================
+// Takes ownership of `fptr`. Returns a malloc'd wide buffer like read_file_to_buffer;
+// `sink` (optional) is offered the text after every block.
+static inline wchar_t *read_compressed_to_buffer(FILE *fptr, InputFormat format, TextDecoder *decoder,
+                                                 DecodeSink *sink, size_t *out_size) {
+    *out_size = 0;
+
+    // Progress is reported against the compressed size
+    long input_size = 0;
+    if (fseek(fptr, 0, SEEK_END) == 0) {
+        input_size = ftell(fptr);
+    }
+    fseek(fptr, 0, SEEK_SET);
+
+    DecompressJob *job = (DecompressJob *)calloc(1, sizeof(DecompressJob));
+    if (job == NULL) {
+        fprintf(stderr, "Error: Failed to allocate decompression state.\n");
+        fclose(fptr);
+        return NULL;
+    }
+    DecodeQueue *q = &job->queue;
+
+    for (int b = 0; b < DECODE_QUEUE_DEPTH; b++) {
+        q->blocks[b].data = (unsigned char *)malloc(DECODE_BLOCK_SIZE);
+        if (q->blocks[b].data == NULL) {
+            fprintf(stderr, "Error: Failed to allocate decode block.\n");
+            for (int k = 0; k < b; k++) free(q->blocks[k].data);
+            free(job);
+            fclose(fptr);
+            return NULL;
+        }
+    }
+
+    if (decompressor_init(&job->dec, format, fptr) != 0) {
+        for (int b = 0; b < DECODE_QUEUE_DEPTH; b++) free(q->blocks[b].data);
+        free(job);
+        fclose(fptr);
+        return NULL;
+    }
+
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+
+    pthread_t thread;
+    bool thread_started = (pthread_create(&thread, NULL, decompress_thread_main, job) == 0);
+    if (!thread_started) {
+        fprintf(stderr, "Error: Failed to start decompression thread.\n");
+    }
+
+    WideText text = { NULL, 0, 0 };
+    bool failed = !thread_started || wide_text_reserve(&text, DECODE_QUEUE_DEPTH * DECODE_BLOCK_SIZE) != 0;
+
+    while (!failed) {
+        pthread_mutex_lock(&q->lock);
+        while (q->count == 0 && !q->done) {
+            pthread_cond_wait(&q->not_empty, &q->lock);
+        }
+        if (q->count == 0) {
+            failed = (q->error != 0);
+            pthread_mutex_unlock(&q->lock);
+            break;
+        }
+        DecodeBlock *block = &q->blocks[q->head];
+        pthread_mutex_unlock(&q->lock);
+
+        if (wide_text_append(&text, decoder, block->data, block->length) != 0) {
+            failed = true;
+            break;
+        }
+        double input_fraction = (input_size > 0) ? (double)block->input_consumed / (double)input_size : 0.0;
+
+        // The block is free again before the sink runs, so inflating continues meanwhile
+        pthread_mutex_lock(&q->lock);
+        q->head = (q->head + 1) % DECODE_QUEUE_DEPTH;
+        q->count--;
+        pthread_cond_signal(&q->not_full);
+        pthread_mutex_unlock(&q->lock);
+
+        if (!decode_sink_offer(sink, &text, input_fraction)) {
+            break;
+        }
+    }
+
+    if (thread_started) {
+        pthread_mutex_lock(&q->lock);
+        q->cancelled = true;
+        pthread_cond_signal(&q->not_full);
+        pthread_mutex_unlock(&q->lock);
+        pthread_join(thread, NULL);
+    }
+
+    decompressor_free(&job->dec);
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+    for (int b = 0; b < DECODE_QUEUE_DEPTH; b++) free(q->blocks[b].data);
+    free(job);
+    fclose(fptr);
+
+    // A read stopped by the sink keeps any sequence cut at the end pending
+    if (!failed && (sink == NULL || !sink->stopped)) {
+        wide_text_finish(&text, decoder);
+    }
+
+    if (failed || text.length == 0) {
+        free(text.data);
+        return NULL;
+    }
+
+    *out_size = text.length;
+    return text.data;
+}
+
+#else // No codec compiled in
+
+static inline wchar_t *read_compressed_to_buffer(FILE *fptr, InputFormat format, TextDecoder *decoder,
+                                                 DecodeSink *sink, size_t *out_size) {
+    (void)decoder;
+    (void)sink;
+    report_unsupported_format(format);
+    fclose(fptr);
+    *out_size = 0;
+    return NULL;
+}
+
+#endif // TA_WITH_ZLIB || TA_WITH_ZSTD
+
+#endif // COMPRESSED_READER_H
@@ -0,0 +1,253 @@
+#ifndef DEADLINE_ANALYSIS_H
+#define DEADLINE_ANALYSIS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <string.h> // For memset
+#include <time.h>   // For clock_gettime
+#include <wchar.h>
+#include "buffer_analyser.h"
+#include "chi_squared.h"
+#include "segmenter.h"
+#include "text_decoder.h" // For DecodeSink
+
+// Deadline-bounded analysis for latency-sensitive callers. The work is done
+// cheapest-and-most-informative first and the deadline is checked between
+// small units of work, so whatever stage is running when time runs out the
+// caller still gets the best verdict found so far:
+//
+//   1. PREFIX  - monograph counts over a growing prefix (a few microseconds)
+//   2. WINDOWS - sliding windows from the start, giving language proportions;
+//                the monograph counts follow the windows past the prefix
+//   3. FULL    - whole-document monograph + bigram score, as perform_final_analysis
+//
+// Histograms are left to the caller, for when time remains after stage 3.
+//
+// The clock starts before the input is read. Stages 1 and 2 run on each block
+// as it arrives (deadline_analysis_sink), so they never wait for the whole
+// file; stage 3 needs all of it. The read stops when the deadline passes.
+
+#define DEADLINE_FIRST_CHUNK 1024      // Always counted, so there is always a verdict
+#define DEADLINE_PREFIX_CHARS 65536    // Prefix stage stops growing here
+#define DEADLINE_FULL_CHUNK 65536      // Full pass checks the clock this often
+
+typedef enum {
+    STAGE_NONE = 0,
+    STAGE_PREFIX,
+    STAGE_WINDOWS,
+    STAGE_FULL
+} AnalysisStage;
+
+typedef struct Deadline {
+    struct timespec start;
+    double budget_ms; // 0 = no limit
+} Deadline;
+
+typedef struct DeadlineResult {
+    int lang;               // LANG_ENG, LANG_FRE or LANG_ERROR (no letters yet)
+    AnalysisStage stage;    // Deepest stage reached
+    bool complete;          // Every stage finished before the deadline
+    size_t length;          // Input characters read
+    double input_fraction;  // Share of the input read (1 unless the read hit the deadline)
+    size_t verdict_chars;   // Characters behind `lang`
+    size_t window_chars;    // Characters covered by the sliding windows
+    size_t eng_chars;       // Window proportions, as run_sliding_windows
+    size_t fre_chars;
+    double coverage;        // Share of the whole input behind `lang` (estimated if not all read)
+    double elapsed_ms;
+    FrequencyData full;     // Whole-document counts, valid when stage == STAGE_FULL
+} DeadlineResult;
+
+static inline void deadline_start(Deadline *deadline, double budget_ms) {
+    clock_gettime(CLOCK_MONOTONIC, &deadline->start);
+    deadline->budget_ms = budget_ms;
+}
+
+static inline double deadline_elapsed_ms(const Deadline *deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - deadline->start.tv_sec) * 1000.0 +
+           (double)(now.tv_nsec - deadline->start.tv_nsec) / 1e6;
+}
+
+static inline bool deadline_passed(const Deadline *deadline) {
+    return deadline->budget_ms > 0.0 && deadline_elapsed_ms(deadline) >= deadline->budget_ms;
+}
+
+// Monograph verdict over the letters counted so far
+static inline int monograph_verdict(const FrequencyData *letters) {
+    if (letters->total_letters < 5) {
+        return LANG_ERROR;
+    }
+    double chi[2];
+    score_monograph(letters, chi);
+    return (chi[LANG_ENG] < chi[LANG_FRE]) ? LANG_ENG : LANG_FRE;
+}
+
+// Counts the letters of buffer[from, to) into the monograph bins only
+static inline void count_prefix_letters(const wchar_t *buffer, size_t from, size_t to, FrequencyData *letters) {
+    for (size_t i = from; i < to; i++) {
+        process_letter_frequency(buffer[i], letters);
+    }
+}
+
+// Stage state, carried from one block of input to the next
+typedef struct DeadlineAnalysis {
+    const Deadline *deadline;
+    FrequencyData letters;  // Monograph bins only: the prefix, then following the windows
+    size_t counted;         // Characters in `letters`
+    size_t chunk;           // Size of the next prefix chunk
+    WindowScan scan;
+    FrequencyData full;     // Whole-document counts (stage 3)
+    bool full_done;
+    bool out_of_time;
+    AnalysisStage stage;
+} DeadlineAnalysis;
+
+static inline void deadline_analysis_init(DeadlineAnalysis *analysis, const Deadline *deadline) {
+    memset(analysis, 0, sizeof(DeadlineAnalysis));
+    analysis->deadline = deadline;
+    analysis->chunk = DEADLINE_FIRST_CHUNK;
+    window_scan_init(&analysis->scan);
+}
+
+// Advances the stages over buffer[0, length): the text read so far, or all of
+// it when `complete`. Returns false once the deadline has passed.
+static inline bool deadline_analysis_feed(DeadlineAnalysis *analysis, const wchar_t *buffer,
+                                          size_t length, bool complete) {
+    const Deadline *deadline = analysis->deadline;
+    if (analysis->out_of_time) {
+        return false;
+    }
+
+    // --- 1. Monograph counts over a prefix, in doubling chunks ---
+    size_t prefix_limit = (length < DEADLINE_PREFIX_CHARS) ? length : DEADLINE_PREFIX_CHARS;
+    while (analysis->counted < prefix_limit) {
+        if (analysis->counted > 0 && deadline_passed(deadline)) {
+            analysis->out_of_time = true;
+            return false;
+        }
+        size_t end = (analysis->counted + analysis->chunk < prefix_limit) ? analysis->counted + analysis->chunk : prefix_limit;
+        count_prefix_letters(buffer, analysis->counted, end, &analysis->letters);
+        analysis->counted = end;
+        analysis->chunk *= 2;
+        analysis->stage = STAGE_PREFIX;
+    }
+    if (!complete && length < DEADLINE_PREFIX_CHARS) {
+        return true; // The whole prefix comes first
+    }
+
+    // --- 2. Sliding windows; the monograph counts follow them past the prefix ---
+    // Until the input is complete only full windows are classified: a shorter
+    // one may still grow
+    analysis->stage = STAGE_WINDOWS;
+    for (;;) {
+        if (deadline_passed(deadline)) {
+            analysis->out_of_time = true;
+            return false;
+        }
+        if (!complete && analysis->scan.position + WINDOW_SIZE > length) {
+            return true;
+        }
+        if (!window_scan_step(&analysis->scan, buffer, length, false)) {
+            break;
+        }
+        size_t reached = (analysis->scan.position < length) ? analysis->scan.position : length;
+        if (reached > analysis->counted) {
+            count_prefix_letters(buffer, analysis->counted, reached, &analysis->letters);
+            analysis->counted = reached;
+        }
+    }
+
+    // --- 3. Whole-document combined score, abandoned if the deadline passes ---
+    FrequencyScan freq_scan;
+    frequency_scan_init(&freq_scan);
+
+    size_t done = 0;
+    while (done < length) {
+        if (deadline_passed(deadline)) {
+            cleanup_frequency_data(&analysis->full);
+            analysis->out_of_time = true;
+            return false;
+        }
+        size_t step = (length - done < DEADLINE_FULL_CHUNK) ? length - done : DEADLINE_FULL_CHUNK;
+        accumulate_frequencies(buffer + done, step, &analysis->full, &freq_scan);
+        done += step;
+    }
+    analysis->full_done = true;
+    analysis->stage = STAGE_FULL;
+    return true;
+}
+
+// DecodeSink callback (context: the DeadlineAnalysis): runs the early stages on
+// the text read so far and stops the read once time is up
+static inline bool deadline_analysis_sink(DecodeSink *sink, const wchar_t *text, size_t length) {
+    return deadline_analysis_feed((DeadlineAnalysis *)sink->context, text, length, false);
+}
+
+// Fills `result` from the stages reached over `length` characters, the
+// `input_fraction` share of the input. Returns the stage reached; when it is
+// STAGE_FULL the caller must cleanup_frequency_data(&result->full).
+static inline AnalysisStage deadline_analysis_result(DeadlineAnalysis *analysis, size_t length,
+                                                     double input_fraction, DeadlineResult *result) {
+    memset(result, 0, sizeof(DeadlineResult));
+    result->stage = analysis->stage;
+    result->length = length;
+    result->input_fraction = input_fraction;
+    result->lang = monograph_verdict(&analysis->letters);
+    result->verdict_chars = analysis->counted;
+    result->window_chars = analysis->scan.finished ? length : analysis->scan.position;
+    result->eng_chars = analysis->scan.eng_chars;
+    result->fre_chars = analysis->scan.fre_chars;
+
+    if (analysis->full_done) {
+        double chi_mono[2];
+        double chi_bigram[2];
+        score_monograph(&analysis->full, chi_mono);
+        score_bigrams(&analysis->full.bigram_map, chi_bigram);
+        result->lang = (chi_mono[LANG_ENG] + chi_bigram[LANG_ENG] < chi_mono[LANG_FRE] + chi_bigram[LANG_FRE])
+                           ? LANG_ENG : LANG_FRE;
+        result->verdict_chars = length;
+        result->full = analysis->full;
+        result->complete = true;
+    }
+
+    result->coverage = (length > 0) ? (double)result->verdict_chars / (double)length * input_fraction : 0.0;
+    result->elapsed_ms = deadline_elapsed_ms(analysis->deadline);
+    return result->stage;
+}
+
+static inline void print_deadline_report(const DeadlineResult *result, double budget_ms) {
+    static const char *const STAGE_NAMES[] = { "none", "prefix monograph", "sliding windows", "full document" };
+
+    printf("\n--- Deadline Analysis (%.3f ms of %.3f ms budget) ---\n", result->elapsed_ms, budget_ms);
+    printf("Stage reached: %s%s\n", STAGE_NAMES[result->stage], result->complete ? " (complete)" : " (partial)");
+    if (result->input_fraction < 1.0) {
+        printf("Input read:       %.2f%% (%zu chars) before the deadline\n",
+               result->input_fraction * 100.0, result->length);
+    }
+    printf("Verdict coverage: %.2f%% (%zu of %zu chars)\n", result->coverage * 100.0,
+           result->verdict_chars, result->length);
+    printf("Window coverage:  %.2f%% (%zu of %zu chars)\n",
+           (result->length > 0) ? (double)result->window_chars / (double)result->length * result->input_fraction * 100.0 : 0.0,
+           result->window_chars, result->length);
+
+    size_t total = result->eng_chars + result->fre_chars;
+    if (total > 0) {
+        double prob_english = (double)result->eng_chars / (double)total * 100.0;
+        printf("Proportion of ENGLISH: %.2f%% | FRENCH: %.2f%%%s\n", prob_english, 100.0 - prob_english,
+               (result->window_chars < result->length || result->input_fraction < 1.0) ? " (windows so far)" : "");
+    }
+
+    printf("\nDOMINANT LANGUAGE OF TEXT:\n");
+    if (result->lang == LANG_ENG) {
+        printf(">>> ENGLISH language (Best Fit by %s) <<<\n", result->complete ? "Combined Score" : "Monograph Score");
+    } else if (result->lang == LANG_FRE) {
+        printf(">>> FRENCH language (Best Fit by %s) <<<\n", result->complete ? "Combined Score" : "Monograph Score");
+    } else {
+        printf(">>> UNDETERMINED (not enough letters before the deadline) <<<\n");
+    }
+}
+
+#endif // DEADLINE_ANALYSIS_H
@@ -0,0 +1,431 @@
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint64_t
+#include <math.h>   // For sqrt
+#include <time.h>   // For clock_gettime
+#include <sys/types.h> // For off_t
+#include "segmenter.h"
+#include "text_decoder.h"
+#include "compressed_reader.h" // For detect_input_format
+
+// Fast estimate of the English/French proportions for very large files.
+// Instead of scanning every sliding window, windows are drawn at random
+// (without replacement) from ESTIMATE_STRATA contiguous strata of the file and
+// read directly at their byte offset. Sampling continues round by round until
+// the 95% confidence interval is narrower than the requested precision, the
+// time budget is spent, or every window has been scored, so the cost depends
+// on the precision asked for rather than on the file size.
+//
+// The population is the file's STEP_SIZE-code-unit positions (bytes for UTF-8
+// and Latin-1). Each sampled window is weighted by the characters decoded from
+// its step, so the estimate is per character like perform_final_analysis's.
+// Those positions are not the windows run_sliding_windows scores (they start
+// every STEP_SIZE characters), so once every position has been sampled the
+// exact answer comes from a full scan instead (estimate_full_scan).
+
+#define ESTIMATE_STRATA 32
+#define ESTIMATE_MIN_SAMPLES 100        // Never stop on precision before this many windows
+#define ESTIMATE_DEFAULT_PRECISION 0.01 // +/- 1 percentage point
+#define ESTIMATE_Z_95 1.959964          // Two-sided 95% normal quantile
+#define ESTIMATE_MAX_BYTES_PER_CHAR 4
+
+typedef enum {
+    ESTIMATE_STOP_PRECISION = 0,
+    ESTIMATE_STOP_BUDGET,
+    ESTIMATE_STOP_EXHAUSTED
+} EstimateStop;
+
+typedef struct EstimateOptions {
+    TextEncoding encoding;
+    double precision;  // Target CI half-width as a fraction (0.01 = +/-1%)
+    double budget_ms;  // Time budget, 0 = no limit
+    uint64_t seed;     // 0 = seed from the clock
+} EstimateOptions;
+
+// Per-stratum sums for the combined ratio estimator. For window i with w_i
+// characters in its step, x_i = w_i if it was classified and y_i = w_i if it
+// was classified English, so y_i is either 0 or x_i and y^2 = x*y.
+typedef struct EstimateStratum {
+    size_t first;      // First window index of the stratum
+    size_t size;       // N_h
+    size_t sampled;    // n_h
+    double sum_x;
+    double sum_y;
+    double sum_x2;
+    double sum_y2;     // Also sum of x*y
+    unsigned bits;     // Permutation domain is 2^bits >= size
+    uint64_t key;
+} EstimateStratum;
+
+typedef struct EstimateResult {
+    double english;    // Estimated proportion (0-1)
+    double half_width; // 95% CI half-width (0-1); 0 only after a full scan
+    size_t sampled;
+    size_t classified;
+    size_t population;
+    size_t scan_windows;    // Full scan, when stop is ESTIMATE_STOP_EXHAUSTED
+    size_t scan_classified;
+    double elapsed_ms;
+    EstimateStop stop;
+} EstimateResult;
+
+// =======================================================
+// RANDOM ORDER WITHOUT REPLACEMENT
+// =======================================================
+static inline uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Bijection on [0, 2^bits): odd multiplications and xorshifts, all invertible mod 2^bits
+static inline uint64_t permute_bits(uint64_t x, unsigned bits, uint64_t key) {
+    uint64_t mask = (bits >= 64) ? ~0ull : ((1ull << bits) - 1);
+    unsigned shift = (bits + 1) / 2;
+
+    for (int round = 0; round < 3; round++) {
+        x = (x ^ (key >> (round * 16))) & mask;
+        x = (x * ((key ^ (0x2545F4914F6CDD1Dull << round)) | 1)) & mask;
+        x ^= x >> shift;
+    }
+    return x;
+}
+
+// j-th window of a stratum in a random order; cycle-walking keeps the result
+// inside [0, size) and the map a permutation
+static inline size_t stratum_window(const EstimateStratum *s, size_t j) {
+    uint64_t x = permute_bits(j, s->bits, s->key);
+    while (x >= s->size) {
+        x = permute_bits(x, s->bits, s->key);
+    }
+    return s->first + (size_t)x;
+}
+
+// =======================================================
+// RANDOM ACCESS WINDOW READING
+// =======================================================
+typedef struct SampleReader {
+    FILE *file;
+    TextEncoding encoding;  // Resolved (never AUTO)
+    off_t data_start;       // Past the byte-order mark
+    off_t data_bytes;
+    unsigned unit_bytes;    // 2 for UTF-16, 1 otherwise
+    unsigned char *bytes;
+    wchar_t *text;
+    size_t read_capacity;
+} SampleReader;
+
+static inline int sample_reader_open(SampleReader *reader, FILE *file, TextEncoding encoding) {
+    memset(reader, 0, sizeof(SampleReader));
+    reader->file = file;
+
+    if (fseeko(file, 0, SEEK_END) != 0) return -1;
+    off_t file_bytes = ftello(file);
+    if (file_bytes < 0 || fseeko(file, 0, SEEK_SET) != 0) return -1;
+
+    // Let the decoder resolve the encoding (and BOM) from the first bytes
+    unsigned char head[3];
+    size_t head_length = fread(head, 1, sizeof(head), file);
+    TextDecoder probe;
+    wchar_t scratch[TEXT_DECODER_MAX_OUTPUT(sizeof(head))];
+    text_decoder_init(&probe, encoding);
+    text_decoder_decode(&probe, head, head_length, scratch);
+
+    reader->encoding = (probe.encoding == TEXT_ENCODING_AUTO) ? TEXT_ENCODING_UTF8 : probe.encoding;
+    reader->unit_bytes = (reader->encoding == TEXT_ENCODING_UTF16LE ||
+                          reader->encoding == TEXT_ENCODING_UTF16BE) ? 2 : 1;
+
+    if (head_length >= 3 && head[0] == 0xEF && head[1] == 0xBB && head[2] == 0xBF &&
+        reader->encoding == TEXT_ENCODING_UTF8) {
+        reader->data_start = 3;
+    } else if (head_length >= 2 && reader->unit_bytes == 2 &&
+               ((head[0] == 0xFF && head[1] == 0xFE) || (head[0] == 0xFE && head[1] == 0xFF))) {
+        reader->data_start = 2;
+    }
+    reader->data_bytes = file_bytes - reader->data_start;
+
+    // Worst case bytes for one window plus a partial sequence to skip at the front
+    size_t max_bytes_per_char = (reader->encoding == TEXT_ENCODING_LATIN1) ? 1 : ESTIMATE_MAX_BYTES_PER_CHAR;
+    reader->read_capacity = (WINDOW_SIZE + 1) * max_bytes_per_char;
+    reader->bytes = (unsigned char *)malloc(reader->read_capacity);
+    reader->text = (wchar_t *)malloc((TEXT_DECODER_MAX_OUTPUT(reader->read_capacity) + 1) * sizeof(wchar_t)); // Two decode calls
+    if (reader->bytes == NULL || reader->text == NULL) {
+        free(reader->bytes);
+        free(reader->text);
+        return -1;
+    }
+    return 0;
+}
+
+static inline void sample_reader_close(SampleReader *reader) {
+    free(reader->bytes);
+    free(reader->text);
+    reader->bytes = NULL;
+    reader->text = NULL;
+}
+
+// Number of sampling positions (one every STEP_SIZE code units)
+static inline size_t sample_reader_windows(const SampleReader *reader) {
+    off_t step_bytes = (off_t)STEP_SIZE * reader->unit_bytes;
+    return (size_t)((reader->data_bytes + step_bytes - 1) / step_bytes);
+}
+
+// Reads and classifies the window starting at position `index`. Returns the
+// classify_window result (WINDOW_TOO_SHORT near the end of the file) and the
+// number of characters in the window's step in `step_chars`.
+static inline int sample_reader_classify(SampleReader *reader, size_t index, size_t *step_chars) {
+    *step_chars = 0;
+    off_t offset = reader->data_start + (off_t)index * STEP_SIZE * reader->unit_bytes;
+    if (fseeko(reader->file, offset, SEEK_SET) != 0) return LANG_ERROR;
+    size_t length = fread(reader->bytes, 1, reader->read_capacity, reader->file);
+
+    // Resynchronise: skip the tail of a character cut by the offset
+    size_t skip = 0;
+    if (reader->encoding == TEXT_ENCODING_UTF8) {
+        while (skip < 3 && skip < length && (reader->bytes[skip] & 0xC0) == 0x80) skip++;
+    } else if (reader->unit_bytes == 2 && length >= 2) {
+        unsigned high = (reader->encoding == TEXT_ENCODING_UTF16LE) ? reader->bytes[1] : reader->bytes[0];
+        if (high >= 0xDC && high <= 0xDF) skip = 2; // Low surrogate
+    }
+
+    // Decode the step first to learn its character count, then the rest of the window
+    size_t step_bytes = (size_t)STEP_SIZE * reader->unit_bytes;
+    if (step_bytes < skip) step_bytes = skip;
+    if (step_bytes > length) step_bytes = length;
+
+    TextDecoder decoder;
+    text_decoder_init(&decoder, reader->encoding);
+    decoder.at_start = false; // Mid-file: no byte-order mark to look for
+    size_t chars = text_decoder_decode(&decoder, reader->bytes + skip, step_bytes - skip, reader->text);
+    *step_chars = chars;
+    chars += text_decoder_decode(&decoder, reader->bytes + step_bytes, length - step_bytes, reader->text + chars);
+    if (chars > WINDOW_SIZE) chars = WINDOW_SIZE; // A trailing partial sequence is never reached
+
+    bool by_stopwords;
+    return classify_window(reader->text, chars, &by_stopwords);
+}
+
+// =======================================================
+// STRATIFIED RATIO ESTIMATE
+// =======================================================
+static inline double elapsed_ms_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1000.0 + (double)(now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Combined ratio estimate R = sum N_h*ybar_h / sum N_h*xbar_h and its
+// linearised variance sum N_h^2 (1 - f_h) s_dh^2 / n_h / X^2 with d = y - R*x
+static inline void estimate_ratio(const EstimateStratum *strata, int count, EstimateResult *result) {
+    double total_x = 0.0, total_y = 0.0;
+
+    for (int h = 0; h < count; h++) {
+        if (strata[h].sampled == 0) continue;
+        double weight = (double)strata[h].size / (double)strata[h].sampled;
+        total_x += weight * strata[h].sum_x;
+        total_y += weight * strata[h].sum_y;
+    }
+    if (total_x <= 0.0) {
+        result->english = 0.5;
+        result->half_width = 0.5;
+        return;
+    }
+
+    double ratio = total_y / total_x;
+    double variance = 0.0;
+    for (int h = 0; h < count; h++) {
+        const EstimateStratum *s = &strata[h];
+        double n = (double)s->sampled;
+        if (s->sampled < 2) {
+            if (s->sampled < s->size) {
+                result->english = ratio;
+                result->half_width = 0.5; // Not enough data for a variance yet
+                return;
+            }
+            continue;
+        }
+        double mean_d = (s->sum_y - ratio * s->sum_x) / n;
+        double sum_d2 = s->sum_y2 - 2.0 * ratio * s->sum_y2 + ratio * ratio * s->sum_x2;
+        double s2 = (sum_d2 - n * mean_d * mean_d) / (n - 1.0);
+        if (s2 < 0.0) s2 = 0.0;
+        double fpc = 1.0 - n / (double)s->size;
+        double size = (double)s->size;
+        variance += size * size * fpc * s2 / n;
+    }
+    variance /= total_x * total_x;
+
+    result->english = ratio;
+    result->half_width = ESTIMATE_Z_95 * sqrt(variance);
+    if (result->half_width > 0.5) result->half_width = 0.5;
+}
+
+// Replaces an exhausted sample with the sliding-window scan of the whole file,
+// the exact result the sample was estimating. Returns -1 if it cannot be read.
+static inline int estimate_full_scan(SampleReader *reader, EstimateResult *result) {
+    size_t file_bytes = (size_t)(reader->data_start + reader->data_bytes);
+    unsigned char *bytes = (unsigned char *)malloc(file_bytes + 1);
+    wchar_t *text = (wchar_t *)malloc((TEXT_DECODER_MAX_OUTPUT(file_bytes) + 1) * sizeof(wchar_t));
+    if (bytes == NULL || text == NULL || fseeko(reader->file, 0, SEEK_SET) != 0 ||
+        fread(bytes, 1, file_bytes, reader->file) != file_bytes) {
+        free(bytes);
+        free(text);
+        return -1;
+    }
+
+    TextDecoder decoder;
+    text_decoder_init(&decoder, reader->encoding); // Skips the byte-order mark again
+    size_t length = text_decoder_decode(&decoder, bytes, file_bytes, text);
+    length += text_decoder_finish(&decoder, text + length);
+    free(bytes);
+
+    WindowScan scan;
+    window_scan_init(&scan);
+    size_t windows = 0;
+    size_t classified = 0;
+    size_t scored = 0;
+    while (window_scan_step(&scan, text, length, false)) {
+        windows++;
+        if (scan.eng_chars + scan.fre_chars > scored) {
+            classified++;
+            scored = scan.eng_chars + scan.fre_chars;
+        }
+    }
+    free(text);
+
+    size_t total = scan.eng_chars + scan.fre_chars;
+    result->english = (total > 0) ? (double)scan.eng_chars / (double)total : 0.5;
+    result->half_width = (total > 0) ? 0.0 : 0.5;
+    result->scan_windows = windows;
+    result->scan_classified = classified;
+    return 0;
+}
+
+// Samples windows of `file` until the precision or budget is met. Returns 0 on
+// success, -1 if the file could not be read.
+static inline int run_estimate(FILE *file, const EstimateOptions *options, EstimateResult *result) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    memset(result, 0, sizeof(EstimateResult));
+
+    SampleReader reader;
+    if (sample_reader_open(&reader, file, options->encoding) != 0) {
+        fprintf(stderr, "Error: Failed to prepare the file for sampling.\n");
+        return -1;
+    }
+
+    size_t population = sample_reader_windows(&reader);
+    result->population = population;
+
+    uint64_t seed_state = options->seed;
+    if (seed_state == 0) seed_state = (uint64_t)start.tv_nsec ^ ((uint64_t)start.tv_sec << 32);
+
+    // Contiguous strata of (almost) equal size
+    int strata_count = (population < ESTIMATE_STRATA) ? (int)population : ESTIMATE_STRATA;
+    EstimateStratum strata[ESTIMATE_STRATA];
+    memset(strata, 0, sizeof(strata));
+    for (int h = 0; h < strata_count; h++) {
+        strata[h].first = population * (size_t)h / (size_t)strata_count;
+        strata[h].size = population * (size_t)(h + 1) / (size_t)strata_count - strata[h].first;
+        while ((1ull << strata[h].bits) < strata[h].size) strata[h].bits++;
+        strata[h].key = splitmix64(&seed_state);
+    }
+
+    // One window per unfinished stratum per round (proportional allocation)
+    result->stop = ESTIMATE_STOP_EXHAUSTED;
+    for (;;) {
+        bool any_left = false;
+        for (int h = 0; h < strata_count; h++) {
+            EstimateStratum *s = &strata[h];
+            if (s->sampled == s->size) continue;
+            any_left = true;
+
+            size_t step_chars;
+            int lang_id = sample_reader_classify(&reader, stratum_window(s, s->sampled), &step_chars);
+            s->sampled++;
+            result->sampled++;
+            if (lang_id == LANG_ENG || lang_id == LANG_FRE) {
+                double weight = (double)step_chars;
+                s->sum_x += weight;
+                s->sum_x2 += weight * weight;
+                result->classified++;
+                if (lang_id == LANG_ENG) {
+                    s->sum_y += weight;
+                    s->sum_y2 += weight * weight;
+                }
+            }
+        }
+        if (!any_left) break;
+
+        estimate_ratio(strata, strata_count, result);
+        if (result->sampled >= ESTIMATE_MIN_SAMPLES && result->half_width <= options->precision) {
+            result->stop = ESTIMATE_STOP_PRECISION;
+            break;
+        }
+        if (options->budget_ms > 0.0 && elapsed_ms_since(&start) >= options->budget_ms) {
+            result->stop = ESTIMATE_STOP_BUDGET;
+            break;
+        }
+    }
+
+    estimate_ratio(strata, strata_count, result);
+
+    // Every position scored: the sample cost as much as a full scan, which is exact
+    if (result->stop == ESTIMATE_STOP_EXHAUSTED && estimate_full_scan(&reader, result) != 0) {
+        fprintf(stderr, "Error: Failed to read the file for the full scan.\n");
+        sample_reader_close(&reader);
+        return -1;
+    }
+    result->elapsed_ms = elapsed_ms_since(&start);
+
+    sample_reader_close(&reader);
+    return 0;
+}
+
+static inline void print_estimate_report(const EstimateResult *result) {
+    static const char *const STOP_REASONS[] = {
+        "target precision reached", "time budget spent", "every position sampled, replaced by the exact full scan"
+    };
+    double english = result->english * 100.0;
+    double french = 100.0 - english;
+    double half_width = result->half_width * 100.0;
+
+    printf("\n\n======================================================\n");
+    printf("     SAMPLED LANGUAGE ESTIMATE\n");
+    printf("======================================================\n");
+    printf("Windows scored: %zu of %zu (%zu classified, %d strata) in %.1f ms\n",
+           result->sampled, result->population, result->classified,
+           (result->population < ESTIMATE_STRATA) ? (int)result->population : ESTIMATE_STRATA,
+           result->elapsed_ms);
+    printf("Stopped: %s\n", STOP_REASONS[result->stop]);
+    bool full_scan = (result->stop == ESTIMATE_STOP_EXHAUSTED);
+    if (full_scan) {
+        printf("Full scan: %zu windows (%zu classified)\n", result->scan_windows, result->scan_classified);
+    }
+
+    printf("\nLanguage Proportions (95%% confidence interval):\n");
+    printf("Proportion of ENGLISH: %.2f%% +/- %.2f%% [%.2f%%, %.2f%%]\n", english, half_width,
+           fmax(english - half_width, 0.0), fmin(english + half_width, 100.0));
+    printf("Proportion of FRENCH:  %.2f%% +/- %.2f%% [%.2f%%, %.2f%%]\n", french, half_width,
+           fmax(french - half_width, 0.0), fmin(french + half_width, 100.0));
+
+    printf("\nDOMINANT LANGUAGE OF TEXT:\n");
+    if ((full_scan ? result->scan_classified : result->classified) == 0) {
+        printf(">>> UNDETERMINED (no window could be classified) <<<\n");
+    } else if (english - half_width > 50.0) {
+        printf(">>> ENGLISH language (%s) <<<\n", full_scan ? "Full Scan" : "Sampled Estimate");
+    } else if (french - half_width > 50.0) {
+        printf(">>> FRENCH language (%s) <<<\n", full_scan ? "Full Scan" : "Sampled Estimate");
+    } else {
+        printf(">>> %s language (Sampled Estimate, interval includes 50%%) <<<\n",
+               (english >= french) ? "ENGLISH" : "FRENCH");
+    }
+}
+
+#endif // ESTIMATOR_H
@@ -78,9 +78,48 @@ static inline unsigned int hash_key(uint32_t key) {
     return key % HASH_TABLE_SIZE;
 }
 
+// Locale-independent letter test. ASCII, Latin-1 and Latin Extended-A (which
+// cover every English and French letter) are decided here so the result does
+// not depend on LC_CTYPE; anything else falls back to iswalpha.
+static inline bool is_letter(wint_t wc) {
+    if (wc < 0x80) {
+        return (wint_t)((wc | 0x20) - L'a') < 26;
+    }
+    if (wc < 0x100) {
+        return wc == 0xAA || wc == 0xB5 || wc == 0xBA ||
+               (wc >= 0xC0 && wc != 0xD7 && wc != 0xF7);
+    }
+    if (wc < 0x180) {
+        return true;
+    }
+    return iswalpha(wc) != 0;
+}
+
+// Locale-independent lowercase mapping, same coverage as is_letter
+static inline wint_t to_lower_letter(wint_t wc) {
+    if (wc < 0x80) {
+        return (wc >= L'A' && wc <= L'Z') ? wc + 0x20 : wc;
+    }
+    if (wc < 0x100) {
+        return (wc >= 0xC0 && wc <= 0xDE && wc != 0xD7) ? wc + 0x20 : wc;
+    }
+    if (wc < 0x180) {
+        if (wc == 0x130) return L'i';  // Dotted capital I
+        if (wc == 0x178) return 0xFF;  // Y with diaeresis
+        if (wc <= 0x137 || (wc >= 0x14A && wc <= 0x177)) {
+            return wc | 1;             // Even = upper, odd = lower
+        }
+        if ((wc >= 0x139 && wc <= 0x148) || (wc >= 0x179 && wc <= 0x17E)) {
+            return (wc & 1) ? wc + 1 : wc; // Odd = upper, even = lower
+        }
+        return wc;
+    }
+    return towlower(wc);
+}
+
 // Maps a wide character to its 0-39 bin index (A-Z or accented)
 static inline int map_letter_to_index(wint_t wc) {
-    wint_t lower = towlower(wc);
+    wint_t lower = to_lower_letter(wc);
     
     if (lower >= L'a' && lower <= L'z') {
         return lower - L'a'; // 0-25 for A-Z
@@ -95,9 +134,14 @@ static inline int map_letter_to_index(wint_t wc) {
     return -1; // Not a tracked character
 }
 
+// Word-char rule shared by the word counter and the word tokenizer
+static inline bool is_word_char(wint_t wc) {
+    return is_letter(wc) || wc == L'\'' || wc == L'-';
+}
+
 // Updates the 40-bin letter frequency (for Monograph Chi-Square)
 static inline void process_letter_frequency(wint_t wc, FrequencyData *data) {
-    if (iswalpha(wc)) {
+    if (is_letter(wc)) {
         int index = map_letter_to_index(wc); 
         
         if (index != -1) {
@@ -113,12 +157,12 @@ static inline void process_letter_frequency(wint_t wc, FrequencyData *data) {
 static inline void process_bigram_count(wint_t wc_prev, wint_t wc_curr, FrequencyData *data) {
     
     // Only count bigrams of two alphabetical characters (normalize case)
-    if (!iswalpha(wc_prev) || !iswalpha(wc_curr)) {
+    if (!is_letter(wc_prev) || !is_letter(wc_curr)) {
         return;
     }
 
-    wint_t char1 = towlower(wc_prev);
-    wint_t char2 = towlower(wc_curr);
+    wint_t char1 = to_lower_letter(wc_prev);
+    wint_t char2 = to_lower_letter(wc_curr);
     
     // Combine two 16-bit wide characters into a 32-bit key
     // This is the unique identifier for the bigram "char1-char2"
@@ -163,8 +207,8 @@ static inline void process_all_character_count(wint_t wc, FrequencyData *data) {
     
     // Normalize letters to lowercase for aggregation in the Full Character Map
     wint_t char_to_count = wc;
-    if (iswalpha(wc)) {
-        char_to_count = towlower(wc);
+    if (is_letter(wc)) {
+        char_to_count = to_lower_letter(wc);
     }
     
     unsigned int index = hash_key((uint32_t)char_to_count); 
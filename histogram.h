@@ -4,13 +4,15 @@
 #include <stdio.h>
 #include <math.h> 
 #include <stdlib.h> // For qsort
-#include <wchar.h> // For wint_t and wprintf
-#include <wctype.h> // For iswprint
+#include <wchar.h> // For wint_t
 #include <stdbool.h> // For bool type
 // Note: We rely on definitions like FrequencyData, TOTAL_BINS, CharMap, CharMapNode, HASH_TABLE_SIZE, and ACCENTED_CHARS from freq_counter.h
 #include "freq_counter.h" 
+#include "word_freq.h" // For WordTable and word_table_sorted
+#include "text_decoder.h" // For encode_utf8 and print_utf8
 
 #define MAX_BAR_LENGTH 50 
+#define TOP_WORDS 10
 
 // Helper structure to link a letter/character with its count for sorting
 // (Re-defined here as the external map_to_array function is no longer used)
@@ -42,12 +44,18 @@ static inline void print_histogram_block(const char *title, CountEntry *counts,
         
         int bar_length = (int)ceil((count / max_freq) * MAX_BAR_LENGTH); 
         
-        if (is_char_map && !iswprint(character)) {
+        // Control characters are shown as code points; everything else is printed
+        // as UTF-8 directly so the output does not depend on the C locale
+        bool is_control = character < 0x20 || (character >= 0x7F && character < 0xA0);
+
+        if (is_char_map && is_control) {
             printf("0x%04X | %6.0f | ", character, count);
         } else if (is_char_map && character == L' ') {
             printf("[SPC] | %6.0f | ", count);
         } else {
-            wprintf(L"%lc | %6.0f | ", character, count);
+            char utf8[5];
+            encode_utf8(character, utf8);
+            printf("%s | %6.0f | ", utf8, count);
         }
 
         for (int j = 0; j < bar_length; j++) {
@@ -153,6 +161,63 @@ static inline void print_letter_histogram(const FrequencyData *data) {
 }
 
 
+// --- FUNCTION: Print the Top Words and Word-Length Distribution ---
+static inline void print_word_histogram(const WordTable *table) {
+
+    if (table->total_words < EPS) {
+        printf("\nCannot generate Word Frequency histogram: No words found.\n");
+        return;
+    }
+
+    size_t num_words = 0;
+    WordCountEntry *words = word_table_sorted(table, &num_words);
+    if (words == NULL) return;
+
+    size_t num_top = (num_words < TOP_WORDS) ? num_words : TOP_WORDS;
+    double max_freq = words[0].count;
+
+    printf("\n======================================================\n");
+    printf(" TOP %zu Words (%zu unique of %.0f total)\n", num_top, num_words, table->total_words);
+    printf("======================================================\n");
+
+    for (size_t i = 0; i < num_top; i++) {
+        int bar_length = (int)ceil((words[i].count / max_freq) * MAX_BAR_LENGTH);
+
+        print_utf8(words[i].word);
+        printf("%*s | %6.0f | ", (words[i].length < 15) ? 15 - (int)words[i].length : 0, "", words[i].count);
+        for (int j = 0; j < bar_length; j++) {
+            printf("*");
+        }
+        printf("\n");
+    }
+    free(words);
+
+    // Word-length distribution (the last bin collects every longer word)
+    double max_len_freq = 0.0;
+    for (int len = 1; len <= MAX_WORD_LENGTH_BIN; len++) {
+        if (table->length_freq[len] > max_len_freq) {
+            max_len_freq = table->length_freq[len];
+        }
+    }
+
+    printf("\n======================================================\n");
+    printf(" WORD LENGTH DISTRIBUTION\n");
+    printf("======================================================\n");
+
+    for (int len = 1; len <= MAX_WORD_LENGTH_BIN; len++) {
+        double count = table->length_freq[len];
+        if (count < EPS) continue;
+
+        int bar_length = (int)ceil((count / max_len_freq) * MAX_BAR_LENGTH);
+        printf("%2d%s | %6.0f | ", len, (len == MAX_WORD_LENGTH_BIN) ? "+" : " ", count);
+        for (int j = 0; j < bar_length; j++) {
+            printf("*");
+        }
+        printf("\n");
+    }
+}
+
+
 // Main function called by main.c
 static inline void print_all_histograms(const FrequencyData *data) {
     print_letter_histogram(data);
@@ -0,0 +1,187 @@
+#ifndef SEGMENTER_H
+#define SEGMENTER_H
+
+#include <stdio.h>
+#include <stdlib.h> // For realloc
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <wchar.h>
+#include "buffer_analyser.h"
+#include "chi_squared.h"
+#include "stopwords.h"
+
+// --- Configuration ---
+#define WINDOW_SIZE 500 
+#define OVERLAP_SIZE 400 
+#define STEP_SIZE (WINDOW_SIZE - OVERLAP_SIZE)
+#define MIN_WINDOW_SIZE 100 
+
+// classify_window result when the slice is too short for any test
+#define WINDOW_TOO_SHORT -2
+
+// Classifies a single window: stopword fast path first for windows shorter than
+// WINDOW_SIZE, chi-square otherwise. Returns LANG_ENG / LANG_FRE, LANG_ERROR
+// when the window has too few letters, or WINDOW_TOO_SHORT when it is below
+// MIN_WINDOW_SIZE and the stopwords were not conclusive.
+static inline int classify_window(const wchar_t *window, size_t size, bool *by_stopwords) {
+    *by_stopwords = false;
+
+    // Fast path: function words decide confident short windows (the tail of a
+    // document, short messages) where chi-square has too few letters. Full
+    // windows keep the chi-square verdict.
+    if (size >= STOPWORD_MIN_WINDOW_SIZE && size < WINDOW_SIZE) {
+        int stopword_lang = classify_by_stopwords(window, size);
+        if (stopword_lang != LANG_ERROR) {
+            *by_stopwords = true;
+            return stopword_lang;
+        }
+    }
+
+    // Too small for chi-square and the stopwords were not conclusive either
+    if (size < MIN_WINDOW_SIZE) {
+        return WINDOW_TOO_SHORT;
+    }
+
+    FrequencyData segment_data = extract_frequencies_from_buffer(window, size);
+    int lang_id = (segment_data.error_code == 0) ? perform_segment_test(&segment_data) : LANG_ERROR;
+    cleanup_frequency_data(&segment_data);
+    return lang_id;
+}
+
+// Verdicts of full windows classified before they can be printed (while the
+// input is still being read the report header is not out yet). One byte per
+// window: the lang_id + 1, plus WINDOW_LOG_STOPWORDS.
+#define WINDOW_LOG_STOPWORDS 0x80
+
+typedef struct WindowLog {
+    unsigned char *verdicts;
+    size_t count;
+    size_t capacity;
+} WindowLog;
+
+// Progress of a sliding-window pass, so the pass can be driven one window at
+// a time (and stopped early) by callers with a time budget.
+typedef struct WindowScan {
+    size_t position;  // Start of the next window
+    size_t eng_chars; // Non-overlapping characters classified English so far
+    size_t fre_chars;
+    bool finished;
+    WindowLog *log;   // When set, verdicts are recorded here instead of printed
+} WindowScan;
+
+static inline void window_scan_init(WindowScan *scan) {
+    scan->position = 0;
+    scan->eng_chars = 0;
+    scan->fre_chars = 0;
+    scan->finished = false;
+    scan->log = NULL;
+}
+
+// Makes room for `windows` more verdicts
+static inline int window_log_reserve(WindowLog *log, size_t windows) {
+    size_t needed = log->count + windows;
+    if (needed <= log->capacity) {
+        return 0;
+    }
+    size_t capacity = (log->capacity > 0) ? log->capacity : 4096;
+    while (capacity < needed) capacity *= 2;
+
+    unsigned char *grown = (unsigned char *)realloc(log->verdicts, capacity);
+    if (grown == NULL) {
+        return -1;
+    }
+    log->verdicts = grown;
+    log->capacity = capacity;
+    return 0;
+}
+
+static inline void print_window_verdict(size_t i, size_t window_size, size_t count_to_add,
+                                        int lang_id, bool by_stopwords) {
+    printf("Chars %05zu-%05zu: ", i, i + window_size - 1);
+
+    const char *source = by_stopwords ? " [stopwords]" : "";
+    if (lang_id == LANG_ENG) {
+        printf("=> ENGLISH%s (Adding %zu chars)\n", source, count_to_add);
+    } else if (lang_id == LANG_FRE) {
+        printf("=> FRENCH%s (Adding %zu chars)\n", source, count_to_add);
+    } else {
+        printf("=> SKIPPED (No letters found in segment)\n");
+    }
+}
+
+// Prints the logged verdicts (full windows from the start of the input) and empties the log
+static inline void window_log_print(WindowLog *log) {
+    for (size_t k = 0; k < log->count; k++) {
+        unsigned char verdict = log->verdicts[k];
+        print_window_verdict(k * STEP_SIZE, WINDOW_SIZE, STEP_SIZE,
+                             (int)(verdict & ~WINDOW_LOG_STOPWORDS) - 1, (verdict & WINDOW_LOG_STOPWORDS) != 0);
+    }
+    free(log->verdicts);
+    log->verdicts = NULL;
+    log->count = 0;
+    log->capacity = 0;
+}
+
+// --- Sliding Window Step (FINAL ROBUST LOGIC) ---
+// Classifies the window at scan->position and adds its non-overlapping
+// character count to the scan. Returns false once the pass is finished.
+// With `verbose` the window verdict is printed, or logged if scan->log is set
+// (the caller reserves room for it).
+static inline bool window_scan_step(WindowScan *scan, const wchar_t *buffer, size_t length, bool verbose) {
+    size_t i = scan->position;
+
+    if (scan->finished || i >= length) {
+        scan->finished = true;
+        return false;
+    }
+
+    // Determine the window size (handle the final, possibly smaller segment)
+    size_t current_window_size = (i + WINDOW_SIZE <= length) ? WINDOW_SIZE : length - i;
+    
+    // Determine the size of the non-overlapping segment for aggregation
+    size_t count_to_add = (i + STEP_SIZE <= length) ? STEP_SIZE : length - i;
+
+    bool by_stopwords;
+    int lang_id = classify_window(buffer + i, current_window_size, &by_stopwords);
+
+    // CRITICAL BREAK: Stop processing if the remaining segment cannot be classified
+    if (lang_id == WINDOW_TOO_SHORT) {
+        scan->finished = true;
+        return false;
+    }
+    
+    if (verbose && scan->log != NULL) {
+        scan->log->verdicts[scan->log->count++] =
+            (unsigned char)((lang_id + 1) | (by_stopwords ? WINDOW_LOG_STOPWORDS : 0));
+    } else if (verbose) {
+        print_window_verdict(i, current_window_size, count_to_add, lang_id, by_stopwords);
+    }
+
+    // --- CORE LOGIC: Accumulate the non-overlapping count ---
+    if (lang_id == LANG_ENG) {
+        scan->eng_chars += count_to_add;
+    } else if (lang_id == LANG_FRE) {
+        scan->fre_chars += count_to_add;
+    }
+    
+    // Move the window to the next step
+    scan->position = i + STEP_SIZE;
+    return true;
+}
+
+// --- Sliding Window Loop ---
+// Adds the non-overlapping character count of every classified window to
+// eng_chars / fre_chars. With `verbose` each window verdict is printed.
+static inline void run_sliding_windows(const wchar_t *buffer, size_t length, bool verbose,
+                                       size_t *eng_chars, size_t *fre_chars) {
+    WindowScan scan;
+    window_scan_init(&scan);
+
+    while (window_scan_step(&scan, buffer, length, verbose)) {
+    }
+
+    *eng_chars += scan.eng_chars;
+    *fre_chars += scan.fre_chars;
+}
+
+#endif // SEGMENTER_H
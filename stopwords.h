@@ -0,0 +1,162 @@
+#ifndef STOPWORDS_H
+#define STOPWORDS_H
+
+#include <wchar.h>
+#include <wctype.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint32_t
+#include <stdio.h>  // For fprintf
+#include "freq_counter.h" // For is_word_char
+#include "chi_squared.h"  // For LANG_ENG, LANG_FRE, LANG_ERROR
+
+// Function words identify the language after a handful of tokens, long before
+// the 40-bin chi-square test has enough letters to be reliable. Confident
+// windows are decided here; ambiguous ones fall back to perform_segment_test.
+
+#define STOPWORD_MAX_LENGTH 5        // Longest word in the table
+#define STOPWORD_MIN_HITS 3          // Stopwords the winning language needs
+#define STOPWORD_DOMINANCE 4         // Winner needs this many times the loser's hits
+#define STOPWORD_MIN_WINDOW_SIZE 20  // Shortest slice worth classifying at all
+
+// =======================================================
+// PERFECT HASH (placed once at startup)
+// =======================================================
+// The slot depends only on the first, second and last characters and the
+// length (the second character of a one-letter word is its terminator). The
+// multiplier is the first one `tests/stopwords_test --search` finds that gives
+// every word in STOPWORD_LIST its own slot: rerun it after editing the list.
+// init_stopword_table still refuses a list the multiplier does not fit.
+#define STOPWORD_TABLE_BITS 9
+#define STOPWORD_TABLE_SIZE (1u << STOPWORD_TABLE_BITS)
+#define STOPWORD_HASH_MULT 2654451691u
+
+#define STOPWORD_KEY(first, second, last, len) \
+    ((uint32_t)(first) + (uint32_t)(second) * 31u + (uint32_t)(last) * 961u + (uint32_t)(len) * 29791u)
+#define STOPWORD_SLOT_WITH(key, mult) ((uint32_t)((uint32_t)(key) * (uint32_t)(mult)) >> (32 - STOPWORD_TABLE_BITS))
+#define STOPWORD_SLOT(first, second, last, len) \
+    STOPWORD_SLOT_WITH(STOPWORD_KEY(first, second, last, len), STOPWORD_HASH_MULT)
+
+typedef struct StopwordEntry {
+    const wchar_t *word; // NULL for an empty slot
+    int length;
+    int lang;            // LANG_ENG or LANG_FRE
+} StopwordEntry;
+
+#define STOPWORD(w, lang) { L##w, (int)(sizeof(L##w) / sizeof(wchar_t)) - 1, lang }
+
+// Words common to both languages ("on", "a", "me", "son", "or", "an", "as") are left out.
+static const StopwordEntry STOPWORD_LIST[] = {
+    // English
+    STOPWORD("the", LANG_ENG), STOPWORD("and", LANG_ENG), STOPWORD("of", LANG_ENG), STOPWORD("to", LANG_ENG),
+    STOPWORD("is", LANG_ENG), STOPWORD("in", LANG_ENG), STOPWORD("that", LANG_ENG), STOPWORD("it", LANG_ENG),
+    STOPWORD("was", LANG_ENG), STOPWORD("for", LANG_ENG), STOPWORD("with", LANG_ENG), STOPWORD("his", LANG_ENG),
+    STOPWORD("her", LANG_ENG), STOPWORD("be", LANG_ENG), STOPWORD("at", LANG_ENG), STOPWORD("by", LANG_ENG),
+    STOPWORD("this", LANG_ENG), STOPWORD("had", LANG_ENG), STOPWORD("not", LANG_ENG), STOPWORD("but", LANG_ENG),
+    STOPWORD("from", LANG_ENG), STOPWORD("have", LANG_ENG), STOPWORD("they", LANG_ENG), STOPWORD("which", LANG_ENG),
+    STOPWORD("you", LANG_ENG), STOPWORD("were", LANG_ENG), STOPWORD("are", LANG_ENG), STOPWORD("she", LANG_ENG),
+    STOPWORD("he", LANG_ENG), STOPWORD("we", LANG_ENG), STOPWORD("their", LANG_ENG), STOPWORD("been", LANG_ENG),
+    STOPWORD("has", LANG_ENG), STOPWORD("would", LANG_ENG), STOPWORD("there", LANG_ENG), STOPWORD("what", LANG_ENG),
+    STOPWORD("will", LANG_ENG), STOPWORD("all", LANG_ENG), STOPWORD("can", LANG_ENG), STOPWORD("if", LANG_ENG),
+    STOPWORD("when", LANG_ENG), STOPWORD("who", LANG_ENG), STOPWORD("them", LANG_ENG), STOPWORD("then", LANG_ENG),
+    STOPWORD("its", LANG_ENG), STOPWORD("our", LANG_ENG),
+    // French
+    STOPWORD("le", LANG_FRE), STOPWORD("la", LANG_FRE), STOPWORD("les", LANG_FRE), STOPWORD("des", LANG_FRE),
+    STOPWORD("du", LANG_FRE), STOPWORD("et", LANG_FRE), STOPWORD("est", LANG_FRE), STOPWORD("une", LANG_FRE),
+    STOPWORD("un", LANG_FRE), STOPWORD("dans", LANG_FRE), STOPWORD("pour", LANG_FRE), STOPWORD("qui", LANG_FRE),
+    STOPWORD("que", LANG_FRE), STOPWORD("pas", LANG_FRE), STOPWORD("sur", LANG_FRE), STOPWORD("au", LANG_FRE),
+    STOPWORD("aux", LANG_FRE), STOPWORD("avec", LANG_FRE), STOPWORD("ce", LANG_FRE), STOPWORD("cette", LANG_FRE),
+    STOPWORD("ces", LANG_FRE), STOPWORD("il", LANG_FRE), STOPWORD("elle", LANG_FRE), STOPWORD("ils", LANG_FRE),
+    STOPWORD("elles", LANG_FRE), STOPWORD("nous", LANG_FRE), STOPWORD("vous", LANG_FRE), STOPWORD("mais", LANG_FRE),
+    STOPWORD("ou", LANG_FRE), STOPWORD("où", LANG_FRE), STOPWORD("leur", LANG_FRE), STOPWORD("sont", LANG_FRE),
+    STOPWORD("été", LANG_FRE), STOPWORD("très", LANG_FRE), STOPWORD("être", LANG_FRE), STOPWORD("avoir", LANG_FRE),
+    STOPWORD("je", LANG_FRE), STOPWORD("tu", LANG_FRE), STOPWORD("se", LANG_FRE), STOPWORD("ne", LANG_FRE),
+    STOPWORD("sa", LANG_FRE), STOPWORD("ses", LANG_FRE), STOPWORD("par", LANG_FRE), STOPWORD("plus", LANG_FRE),
+    STOPWORD("c'est", LANG_FRE), STOPWORD("n'est", LANG_FRE), STOPWORD("qu'il", LANG_FRE), STOPWORD("de", LANG_FRE),
+    STOPWORD("en", LANG_FRE), STOPWORD("y", LANG_FRE), STOPWORD("était", LANG_FRE), STOPWORD("aussi", LANG_FRE),
+    STOPWORD("comme", LANG_FRE),
+};
+
+#define STOPWORD_COUNT (sizeof(STOPWORD_LIST) / sizeof(STOPWORD_LIST[0]))
+
+static StopwordEntry STOPWORD_TABLE[STOPWORD_TABLE_SIZE];
+
+// Must run before any window is classified. Returns -1 if two words share a
+// slot (the multiplier no longer fits the word list).
+static inline int init_stopword_table(void) {
+    for (size_t k = 0; k < STOPWORD_COUNT; k++) {
+        const StopwordEntry *entry = &STOPWORD_LIST[k];
+        uint32_t slot = STOPWORD_SLOT(entry->word[0], entry->word[1], entry->word[entry->length - 1], entry->length);
+
+        if (STOPWORD_TABLE[slot].word != NULL) {
+            fprintf(stderr, "Error: Stopwords '%ls' and '%ls' share hash slot %u.\n",
+                    STOPWORD_TABLE[slot].word, entry->word, (unsigned)slot);
+            return -1;
+        }
+        STOPWORD_TABLE[slot] = *entry;
+    }
+    return 0;
+}
+
+// Looks up a token; returns its language or LANG_ERROR if it is not a stopword
+static inline int lookup_stopword(const wchar_t *word, size_t length) {
+    if (length == 0 || length > STOPWORD_MAX_LENGTH) {
+        return LANG_ERROR;
+    }
+
+    wint_t first = to_lower_letter(word[0]);
+    wint_t second = (length > 1) ? to_lower_letter(word[1]) : L'\0';
+    wint_t last = to_lower_letter(word[length - 1]);
+
+    const StopwordEntry *entry = &STOPWORD_TABLE[STOPWORD_SLOT(first, second, last, length)];
+    if (entry->word == NULL || entry->length != (int)length) {
+        return LANG_ERROR;
+    }
+
+    for (size_t k = 0; k < length; k++) {
+        if ((wint_t)entry->word[k] != to_lower_letter(word[k])) {
+            return LANG_ERROR;
+        }
+    }
+    return entry->lang;
+}
+
+// =======================================================
+// STOPWORD PRE-CLASSIFIER
+// =======================================================
+// Returns LANG_ENG or LANG_FRE for a confident slice, LANG_ERROR when the
+// caller should fall back to the chi-square test.
+static inline int classify_by_stopwords(const wchar_t *buffer, size_t length) {
+    int eng_hits = 0;
+    int fre_hits = 0;
+    size_t i = 0;
+
+    while (i < length) {
+        if (!is_word_char(buffer[i])) {
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < length && is_word_char(buffer[i])) {
+            i++;
+        }
+
+        int lang = lookup_stopword(buffer + start, i - start);
+        if (lang == LANG_ENG) {
+            eng_hits++;
+        } else if (lang == LANG_FRE) {
+            fre_hits++;
+        }
+    }
+
+    if (eng_hits >= STOPWORD_MIN_HITS && eng_hits >= fre_hits * STOPWORD_DOMINANCE) {
+        return LANG_ENG;
+    }
+    if (fre_hits >= STOPWORD_MIN_HITS && fre_hits >= eng_hits * STOPWORD_DOMINANCE) {
+        return LANG_FRE;
+    }
+    return LANG_ERROR;
+}
+
+#endif // STOPWORDS_H
@@ -0,0 +1,198 @@
+// End-to-end check of --checkpoint / --resume (checkpoint.h, driven by
+// text_analyser.c): a run stopped by SIGTERM and resumed gives the same window
+// verdicts and the same final report as an uninterrupted run, and a periodic
+// save that fails does not stop the analysis.
+//
+// Build and run from the repository root:
+//   gcc -O2 -Wall -pthread tests/checkpoint_test.c -o /tmp/checkpoint_test -lm
+//   /tmp/checkpoint_test
+
+#define main text_analyser_main
+#include "../text_analyser.c"
+#undef main
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+static int failures = 0;
+
+#define CHECK(cond, name) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s (%s)\n", name, #cond); failures++; } \
+    else { printf("ok: %s\n", name); } \
+} while (0)
+
+#define INPUT_PARAGRAPHS 6000 // About 2M characters: long enough to stop midway
+#define INTERVAL_ARG "--checkpoint-interval=0.02"
+#define ATTEMPTS 3            // A run that ends before the signal gets a few tries
+
+static const char *const PARAGRAPHS[] = {
+    "The committee will meet again on Thursday to discuss the budget for the coming year, "
+    "and every member should bring the figures that were requested at the last meeting. ",
+    "Le conseil se r\xC3\xA9unira de nouveau jeudi pour discuter du budget de l'ann\xC3\xA9" "e prochaine, "
+    "et chaque membre devra apporter les chiffres demand\xC3\xA9s lors de la derni\xC3\xA8re r\xC3\xA9union. ",
+    "She said that the weather had been much better than they expected, so the whole family "
+    "spent most of the afternoon walking along the river before dinner. ",
+    "Elle a dit que le temps avait \xC3\xA9t\xC3\xA9 bien meilleur que pr\xC3\xA9vu, alors toute la famille "
+    "a pass\xC3\xA9 l'apr\xC3\xA8s-midi \xC3\xA0 se promener le long de la rivi\xC3\xA8re avant le d\xC3\xAEner. ",
+};
+
+typedef struct RunOutput {
+    int exit_code; // -1 if the run did not exit normally
+    char *text;    // Everything the run printed to stdout
+} RunOutput;
+
+// Writes mixed English and French text; runs of each language vary in length
+static int write_input(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) return -1;
+    uint32_t state = 12345u;
+    for (int i = 0; i < INPUT_PARAGRAPHS; i++) {
+        state = state * 1103515245u + 12345u;
+        int language = (int)((state >> 16) % 3 == 0); // 0: English, 1: French
+        fputs(PARAGRAPHS[language * 2 + (int)((state >> 20) & 1)], out);
+        if ((state >> 24) % 5 == 0) fputc('\n', out);
+    }
+    return fclose(out);
+}
+
+// Starts the analyser on `args` in a fresh child process with stdout in `out_fd`
+static pid_t start_run(char *const args[], int arg_count, int *out_fd) {
+    char out_path[] = "/tmp/checkpoint_test_out_XXXXXX";
+    *out_fd = mkstemp(out_path);
+    if (*out_fd < 0) return -1;
+    unlink(out_path);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(*out_fd, STDOUT_FILENO);
+        char *argv[8] = { "text_analyser" };
+        for (int k = 0; k < arg_count && k < 6; k++) argv[k + 1] = args[k];
+        exit(text_analyser_main(arg_count + 1, argv));
+    }
+    return pid;
+}
+
+// Waits for the child and reads what it printed
+static RunOutput finish_run(pid_t pid, int out_fd) {
+    RunOutput run = { -1, NULL };
+    int status = 0;
+    if (pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status)) {
+        run.exit_code = WEXITSTATUS(status);
+    }
+    off_t size = lseek(out_fd, 0, SEEK_END);
+    run.text = calloc((size_t)(size > 0 ? size : 0) + 1, 1);
+    if (run.text != NULL && size > 0 && pread(out_fd, run.text, (size_t)size, 0) != (ssize_t)size) {
+        run.text[0] = '\0';
+    }
+    close(out_fd);
+    return run;
+}
+
+static RunOutput run_to_end(char *const args[], int arg_count) {
+    int out_fd;
+    pid_t pid = start_run(args, arg_count, &out_fd);
+    if (pid < 0) return (RunOutput){ -1, NULL };
+    return finish_run(pid, out_fd);
+}
+
+// Appends every window verdict line ("Chars ...") of `text` to `windows`
+static void collect_windows(const char *text, char *windows) {
+    size_t used = strlen(windows);
+    for (const char *line = text; line != NULL && *line != '\0';) {
+        const char *end = strchr(line, '\n');
+        size_t length = (end != NULL) ? (size_t)(end - line) + 1 : strlen(line);
+        if (strncmp(line, "Chars ", 6) == 0) {
+            memcpy(windows + used, line, length);
+            used += length;
+        }
+        line += length;
+    }
+    windows[used] = '\0';
+}
+
+// The final report: everything from the end of the window loop on
+static const char *report_of(const RunOutput *run) {
+    const char *report = (run->text != NULL) ? strstr(run->text, "--- Segmentation Complete ---") : NULL;
+    return (report != NULL) ? report : "(no report)";
+}
+
+int main(void) {
+    char input[] = "/tmp/checkpoint_test_in_XXXXXX";
+    int fd = mkstemp(input);
+    if (fd < 0 || close(fd) != 0 || write_input(input) != 0) {
+        fprintf(stderr, "FAIL: could not write the test input\n");
+        return EXIT_FAILURE;
+    }
+    char checkpoint[sizeof(input) + 8];
+    snprintf(checkpoint, sizeof(checkpoint), "%s.ckpt", input);
+    char checkpoint_arg[sizeof(checkpoint) + 16];
+    snprintf(checkpoint_arg, sizeof(checkpoint_arg), "--checkpoint=%s", checkpoint);
+
+    // --- Reference: one uninterrupted run ---
+    char *plain_args[] = { input };
+    RunOutput reference = run_to_end(plain_args, 1);
+    CHECK(reference.exit_code == 0 && strstr(report_of(&reference), "=====") != NULL, "uninterrupted run");
+
+    // --- SIGTERM once the first periodic checkpoint is on disk, then --resume ---
+    RunOutput stopped = { -1, NULL };
+    bool interrupted = false;
+    for (int attempt = 0; attempt < ATTEMPTS && !interrupted; attempt++) {
+        free(stopped.text);
+        remove(checkpoint);
+        char *args[] = { checkpoint_arg, INTERVAL_ARG, input };
+        int out_fd;
+        pid_t pid = start_run(args, 3, &out_fd);
+        while (pid > 0 && access(checkpoint, F_OK) != 0 && waitpid(pid, NULL, WNOHANG) == 0) {
+            usleep(1000);
+        }
+        if (pid > 0) kill(pid, SIGTERM);
+        stopped = finish_run(pid, out_fd);
+        interrupted = (stopped.exit_code == EXIT_FAILURE && access(checkpoint, F_OK) == 0);
+    }
+    CHECK(interrupted, "SIGTERM stops the run and leaves a checkpoint");
+    CHECK(stopped.text != NULL && strstr(stopped.text, "--- Segmentation Complete ---") == NULL,
+          "interrupted run prints no report");
+
+    char *resume_args[] = { checkpoint_arg, "--resume", input };
+    RunOutput resumed = run_to_end(resume_args, 3);
+    CHECK(resumed.exit_code == 0 && resumed.text != NULL && strstr(resumed.text, "Resuming from checkpoint") != NULL,
+          "resumed run completes");
+    CHECK(access(checkpoint, F_OK) != 0, "checkpoint removed once the run completes");
+    CHECK(strcmp(report_of(&resumed), report_of(&reference)) == 0, "resumed report matches the uninterrupted run");
+
+    size_t capacity = (reference.text != NULL ? strlen(reference.text) : 0) + 1;
+    char *expected = malloc(capacity);
+    char *joined = malloc(capacity + (stopped.text != NULL ? strlen(stopped.text) : 0) +
+                          (resumed.text != NULL ? strlen(resumed.text) : 0));
+    if (expected != NULL && joined != NULL) {
+        expected[0] = joined[0] = '\0';
+        collect_windows(reference.text, expected);
+        collect_windows(stopped.text, joined);
+        collect_windows(resumed.text, joined);
+        CHECK(expected[0] != '\0' && strcmp(joined, expected) == 0,
+              "window verdicts before and after the stop match the uninterrupted run");
+    }
+    free(expected);
+    free(joined);
+
+    // --- A periodic save that cannot be written only warns ---
+    char *unwritable_args[] = { "--checkpoint=/nonexistent-dir/run.ckpt", INTERVAL_ARG, input };
+    RunOutput unwritable = run_to_end(unwritable_args, 3);
+    CHECK(unwritable.exit_code == 0 && strcmp(report_of(&unwritable), report_of(&reference)) == 0,
+          "failed periodic checkpoint does not stop the run");
+
+    free(reference.text);
+    free(stopped.text);
+    free(resumed.text);
+    free(unwritable.text);
+    remove(checkpoint);
+    unlink(input);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d checkpoint test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All checkpoint tests passed\n");
+    return EXIT_SUCCESS;
+}
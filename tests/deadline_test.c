@@ -0,0 +1,109 @@
+// End-to-end check of --deadline-ms (deadline_analysis.h, driven by
+// text_analyser.c): a short message is analysed completely well inside a 2 ms
+// budget, counted from the start of main as the README promises.
+//
+// Build and run from the repository root:
+//   gcc -O2 -Wall -pthread tests/deadline_test.c -o /tmp/deadline_test -lm
+//   /tmp/deadline_test
+
+#define main text_analyser_main
+#include "../text_analyser.c"
+#undef main
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+static int failures = 0;
+
+#define CHECK(cond, name) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s (%s)\n", name, #cond); failures++; } \
+    else { printf("ok: %s\n", name); } \
+} while (0)
+
+#define BUDGET_ARG "--deadline-ms=2"
+#define WELL_INSIDE_MS 0.5 // A quarter of the budget
+#define ATTEMPTS 3         // A busy machine gets a few tries
+
+static const char MESSAGE[] =
+    "Bonjour, je voudrais r\xC3\xA9server une table pour deux personnes ce soir, merci beaucoup.\n";
+
+typedef struct DeadlineRun {
+    double elapsed_ms;
+    bool complete;
+    bool french;
+} DeadlineRun;
+
+// Runs the analyser on `path` in a fresh child process and reads its report
+static int run_once(const char *path, DeadlineRun *run) {
+    char out_path[] = "/tmp/deadline_test_out_XXXXXX";
+    int out_fd = mkstemp(out_path);
+    if (out_fd < 0) return -1;
+    unlink(out_path);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(out_fd);
+        return -1;
+    }
+    if (pid == 0) {
+        dup2(out_fd, STDOUT_FILENO);
+        char *argv[] = { "text_analyser", BUDGET_ARG, (char *)path, NULL };
+        exit(text_analyser_main(3, argv));
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    memset(run, 0, sizeof(DeadlineRun));
+    bool reported = false;
+
+    FILE *out = fdopen(out_fd, "r");
+    if (out == NULL) {
+        close(out_fd);
+        return -1;
+    }
+    rewind(out);
+    char line[256];
+    while (fgets(line, sizeof(line), out) != NULL) {
+        if (sscanf(line, "--- Deadline Analysis (%lf ms", &run->elapsed_ms) == 1) reported = true;
+        if (strstr(line, "Stage reached: full document (complete)") != NULL) run->complete = true;
+        if (strstr(line, ">>> FRENCH language") != NULL) run->french = true;
+    }
+    fclose(out);
+    return (reported && WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+int main(void) {
+    char path[] = "/tmp/deadline_test_msg_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, MESSAGE, sizeof(MESSAGE) - 1) != (ssize_t)(sizeof(MESSAGE) - 1)) {
+        fprintf(stderr, "FAIL: could not write the test message\n");
+        return EXIT_FAILURE;
+    }
+    close(fd);
+
+    DeadlineRun best = { 1e9, false, false };
+    bool ran = true;
+    for (int attempt = 0; attempt < ATTEMPTS && best.elapsed_ms >= WELL_INSIDE_MS; attempt++) {
+        DeadlineRun run;
+        if (run_once(path, &run) != 0) {
+            ran = false;
+            break;
+        }
+        printf("  attempt %d: %.3f ms\n", attempt + 1, run.elapsed_ms);
+        if (run.elapsed_ms < best.elapsed_ms) best = run;
+    }
+    unlink(path);
+
+    CHECK(ran, "deadline run reports");
+    CHECK(best.complete, "short message reaches the full-document stage");
+    CHECK(best.french, "short message verdict");
+    CHECK(best.elapsed_ms < WELL_INSIDE_MS, "short message finishes well inside a 2 ms budget");
+
+    if (failures > 0) {
+        fprintf(stderr, "%d deadline test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All deadline tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+// Regression tests for gzip end-of-stream handling in compressed_reader.h.
+//
+// Build and run from the repository root:
+//   gcc -O2 -Wall -pthread -DTA_WITH_ZLIB tests/gzip_boundary_test.c -o /tmp/gzip_boundary_test -lz
+//   /tmp/gzip_boundary_test
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "../compressed_reader.h"
+
+static int failures = 0;
+
+#define CHECK(cond, name) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s (%s)\n", name, #cond); failures++; } \
+    else { printf("ok: %s\n", name); } \
+} while (0)
+
+// Pseudo-random lowercase words: compresses to roughly 60% of its size, so the
+// header padding needed to reach a read boundary stays small
+static size_t make_text(unsigned char *text, size_t length) {
+    unsigned seed = 12345;
+    for (size_t n = 0; n < length; n++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = (seed >> 16) % 32;
+        text[n] = (r < 26) ? (unsigned char)('a' + r) : ' ';
+    }
+    return length;
+}
+
+// Writes one gzip member of `text` to `out`, padding the header's extra field
+// so that the member is exactly `member_size` bytes. Returns the size written.
+static size_t gzip_member(const unsigned char *text, size_t length, size_t member_size, unsigned char *out, size_t capacity) {
+    static unsigned char extra[65536];
+    size_t extra_len = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        if (deflateInit2(&zs, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return 0;
+
+        gz_header header;
+        memset(&header, 0, sizeof(header));
+        header.os = 3;
+        if (extra_len > 0) {
+            header.extra = extra;
+            header.extra_len = (uInt)extra_len;
+        }
+        deflateSetHeader(&zs, &header);
+
+        zs.next_in = (unsigned char *)text;
+        zs.avail_in = (uInt)length;
+        zs.next_out = out;
+        zs.avail_out = (uInt)capacity;
+        int ret = deflate(&zs, Z_FINISH);
+        size_t written = zs.total_out;
+        deflateEnd(&zs);
+        if (ret != Z_STREAM_END) return 0;
+
+        if (member_size == 0 || written == member_size) return written;
+        if (pass == 1 || written + 2 > member_size) return 0;
+        // The FEXTRA field adds its 2-byte length plus the data
+        extra_len = member_size - written - 2;
+        memset(extra, 'x', extra_len);
+    }
+    return 0;
+}
+
+// Runs `bytes` through read_compressed_to_buffer. Returns the decoded length, or
+// (size_t)-1 when the reader reports an error.
+static size_t read_gzip(const unsigned char *bytes, size_t size, wchar_t **out_text) {
+    FILE *f = tmpfile();
+    if (f == NULL || fwrite(bytes, 1, size, f) != size) {
+        perror("tmpfile");
+        exit(2);
+    }
+    rewind(f);
+
+    TextDecoder decoder;
+    text_decoder_init(&decoder, TEXT_ENCODING_UTF8);
+    size_t length = 0;
+    wchar_t *text = read_compressed_to_buffer(f, INPUT_GZIP, &decoder, NULL, &length);
+    if (text == NULL) {
+        return (size_t)-1;
+    }
+    *out_text = text;
+    return length;
+}
+
+static bool matches(const wchar_t *wide, size_t wide_length, const unsigned char *text, size_t length, size_t repeats) {
+    if (wide_length != length * repeats) return false;
+    for (size_t i = 0; i < wide_length; i++) {
+        if (wide[i] != (wchar_t)text[i % length]) return false;
+    }
+    return true;
+}
+
+int main(void) {
+    static unsigned char text[2 * COMPRESSED_READ_SIZE];
+    static unsigned char gz[4 * COMPRESSED_READ_SIZE + 4096];
+    size_t text_length = make_text(text, COMPRESSED_READ_SIZE);
+    wchar_t *wide = NULL;
+    size_t length;
+
+    // A member ending exactly on the read boundary, alone and twice over
+    for (size_t reads = 1; reads <= 2; reads++) {
+        size_t member_text = make_text(text, reads * COMPRESSED_READ_SIZE);
+        size_t size = gzip_member(text, member_text, reads * COMPRESSED_READ_SIZE, gz, sizeof(gz));
+        CHECK(size == reads * COMPRESSED_READ_SIZE, "build member on read boundary");
+
+        length = read_gzip(gz, size, &wide);
+        CHECK(length != (size_t)-1 && matches(wide, length, text, member_text, 1),
+              reads == 1 ? "member of exactly one read" : "member of exactly two reads");
+        if (length != (size_t)-1) free(wide);
+    }
+
+    // Two concatenated members, the first ending exactly on the read boundary
+    size_t first = gzip_member(text, text_length, COMPRESSED_READ_SIZE, gz, sizeof(gz));
+    size_t second = gzip_member(text, text_length, 0, gz + first, sizeof(gz) - first);
+    length = read_gzip(gz, first + second, &wide);
+    CHECK(length != (size_t)-1 && matches(wide, length, text, text_length, 2), "second member after read boundary");
+    if (length != (size_t)-1) free(wide);
+
+    // Trailing zero padding, short and past the next read boundary
+    size_t member = gzip_member(text, text_length, 0, gz, sizeof(gz));
+    size_t paddings[2] = { 512, 2 * COMPRESSED_READ_SIZE - member + 17 };
+    for (int p = 0; p < 2; p++) {
+        memset(gz + member, 0, paddings[p]);
+        length = read_gzip(gz, member + paddings[p], &wide);
+        CHECK(length != (size_t)-1 && matches(wide, length, text, text_length, 1),
+              p == 0 ? "short zero padding" : "zero padding across read boundary");
+        if (length != (size_t)-1) free(wide);
+    }
+
+    // A truncated member is still an error, including on the read boundary
+    member = gzip_member(text, text_length, COMPRESSED_READ_SIZE + 100, gz, sizeof(gz));
+    length = read_gzip(gz, COMPRESSED_READ_SIZE, &wide);
+    CHECK(length == (size_t)-1, "member truncated on read boundary");
+    if (length != (size_t)-1) free(wide);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("All gzip boundary tests passed\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Tests for the stopword table (stopwords.h) and the window fast path (segmenter.h).
+//
+// Build and run from the repository root:
+//   gcc -O2 -Wall tests/stopwords_test.c -o /tmp/stopwords_test -lm
+//   /tmp/stopwords_test
+//
+// After editing STOPWORD_LIST, `/tmp/stopwords_test --search` prints the
+// STOPWORD_HASH_MULT line to paste into stopwords.h.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include "../segmenter.h"
+
+static int failures = 0;
+
+#define CHECK(cond, name) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s (%s)\n", name, #cond); failures++; } \
+    else { printf("ok: %s\n", name); } \
+} while (0)
+
+// Locale-independent inverse of to_lower_letter for ASCII and Latin-1 letters
+static wchar_t upper_letter(wchar_t wc) {
+    if ((wc >= L'a' && wc <= L'z') || (wc >= 0xE0 && wc <= 0xFE && wc != 0xF7)) {
+        return wc - 0x20;
+    }
+    return wc;
+}
+
+// Prints the first odd multiplier from 2^32 / golden ratio upwards that gives
+// every stopword its own slot
+static int search_multiplier(void) {
+    for (uint64_t mult = 2654435769u; mult <= UINT32_MAX; mult += 2) {
+        bool used[STOPWORD_TABLE_SIZE] = { false };
+        bool fits = true;
+        for (size_t k = 0; k < STOPWORD_COUNT && fits; k++) {
+            const StopwordEntry *entry = &STOPWORD_LIST[k];
+            uint32_t key = STOPWORD_KEY(entry->word[0], entry->word[1], entry->word[entry->length - 1], entry->length);
+            uint32_t slot = STOPWORD_SLOT_WITH(key, mult);
+            fits = !used[slot];
+            used[slot] = true;
+        }
+        if (fits) {
+            printf("#define STOPWORD_HASH_MULT %uu\n", (unsigned)mult);
+            return 0;
+        }
+    }
+    fprintf(stderr, "No multiplier fits %zu words in %u slots: raise STOPWORD_TABLE_BITS.\n",
+            (size_t)STOPWORD_COUNT, STOPWORD_TABLE_SIZE);
+    return 1;
+}
+
+// Fills `window` with copies of `text` up to `size` characters
+static void repeat_text(wchar_t *window, size_t size, const wchar_t *text) {
+    size_t text_length = wcslen(text);
+    for (size_t i = 0; i < size; i++) {
+        window[i] = text[i % text_length];
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--search") == 0) {
+        return search_multiplier();
+    }
+
+    CHECK(init_stopword_table() == 0, "every stopword has its own slot");
+
+    // Each word hashes back to the slot holding it, in any case
+    bool all_found = true;
+    size_t placed = 0;
+    for (size_t k = 0; k < STOPWORD_COUNT; k++) {
+        const StopwordEntry *entry = &STOPWORD_LIST[k];
+        wchar_t upper[STOPWORD_MAX_LENGTH + 1];
+        for (int c = 0; c <= entry->length; c++) {
+            upper[c] = upper_letter(entry->word[c]);
+        }
+        if (entry->length > STOPWORD_MAX_LENGTH ||
+            lookup_stopword(entry->word, (size_t)entry->length) != entry->lang ||
+            lookup_stopword(upper, (size_t)entry->length) != entry->lang) {
+            fprintf(stderr, "  lookup failed for '%ls'\n", entry->word);
+            all_found = false;
+        }
+    }
+    for (size_t slot = 0; slot < STOPWORD_TABLE_SIZE; slot++) {
+        if (STOPWORD_TABLE[slot].word != NULL) placed++;
+    }
+    CHECK(all_found, "every stopword is found");
+    CHECK(lookup_stopword(L"\u00C9T\u00C9", 3) == LANG_FRE && lookup_stopword(L"TR\u00C8S", 4) == LANG_FRE &&
+          lookup_stopword(L"O\u00D9", 2) == LANG_FRE && lookup_stopword(L"\u00CATRE", 4) == LANG_FRE,
+          "accented uppercase stopwords are found");
+    CHECK(placed == STOPWORD_COUNT, "no stopword was overwritten");
+    CHECK(lookup_stopword(L"thee", 4) == LANG_ERROR && lookup_stopword(L"lex", 3) == LANG_ERROR,
+          "other words are not stopwords");
+
+    // Stopwords decide short windows; full windows always get the chi-square test
+    static const wchar_t *const TEXTS[2] = {
+        L"the cat and the dog were in the garden with all of their toys. ",
+        L"le chat et le chien sont dans le jardin avec tous les jouets. ",
+    };
+    wchar_t window[WINDOW_SIZE];
+    for (int lang = LANG_ENG; lang <= LANG_FRE; lang++) {
+        bool by_stopwords;
+        repeat_text(window, WINDOW_SIZE, TEXTS[lang]);
+
+        int short_lang = classify_window(window, WINDOW_SIZE - 1, &by_stopwords);
+        CHECK(short_lang == lang && by_stopwords, lang == LANG_ENG ? "short English window by stopwords" : "short French window by stopwords");
+
+        classify_window(window, WINDOW_SIZE, &by_stopwords);
+        CHECK(!by_stopwords, lang == LANG_ENG ? "full English window by chi-square" : "full French window by chi-square");
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "%d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("All stopword tests passed\n");
+    return 0;
+}
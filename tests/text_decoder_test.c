@@ -0,0 +1,148 @@
+// Tests for the built-in decoder (text_decoder.h) and the letter helpers it
+// feeds (freq_counter.h).
+//
+// Build and run from the repository root:
+//   gcc -O2 -Wall tests/text_decoder_test.c -o /tmp/text_decoder_test -lm
+//   /tmp/text_decoder_test
+//
+// Every input is decoded whole and in every smaller block size, so sequences,
+// surrogate pairs and byte-order marks are also split across calls.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include "../text_decoder.h"
+#include "../freq_counter.h"
+
+static int failures = 0;
+
+#define CHECK(cond, name) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s (%s)\n", name, #cond); failures++; } \
+    else { printf("ok: %s\n", name); } \
+} while (0)
+
+#define MAX_TEXT 64
+
+typedef struct Decoded {
+    wchar_t text[MAX_TEXT + 1];
+    size_t length;
+    size_t invalid;
+    TextEncoding encoding;
+    bool within_bound; // No call wrote more than TEXT_DECODER_MAX_OUTPUT
+} Decoded;
+
+static Decoded decode_in_blocks(TextEncoding encoding, const unsigned char *bytes, size_t length, size_t block) {
+    Decoded out;
+    memset(&out, 0, sizeof(out));
+    out.within_bound = true;
+
+    TextDecoder decoder;
+    text_decoder_init(&decoder, encoding);
+    for (size_t i = 0; i < length; i += block) {
+        size_t step = (length - i < block) ? length - i : block;
+        size_t written = text_decoder_decode(&decoder, bytes + i, step, out.text + out.length);
+        if (written > TEXT_DECODER_MAX_OUTPUT(step)) out.within_bound = false;
+        out.length += written;
+    }
+    out.length += text_decoder_finish(&decoder, out.text + out.length);
+    out.invalid = decoder.invalid_sequences;
+    out.encoding = decoder.encoding;
+    return out;
+}
+
+// True if every block size gives `expected`, `invalid` replacements and `resolved`
+static bool decodes_to(TextEncoding encoding, const unsigned char *bytes, size_t length,
+                       const wchar_t *expected, size_t invalid, TextEncoding resolved) {
+    size_t expected_length = wcslen(expected);
+    for (size_t block = 1; block <= length || block == 1; block++) {
+        Decoded out = decode_in_blocks(encoding, bytes, length, block);
+        if (out.length != expected_length || wmemcmp(out.text, expected, expected_length) != 0 ||
+            out.invalid != invalid || out.encoding != resolved || !out.within_bound) {
+            fprintf(stderr, "  block size %zu: %zu chars, %zu invalid, encoding %d\n",
+                    block, out.length, out.invalid, (int)out.encoding);
+            return false;
+        }
+    }
+    return true;
+}
+
+#define DECODES_TO(encoding, bytes, expected, invalid, resolved) \
+    decodes_to(encoding, (const unsigned char *)(bytes), sizeof(bytes) - 1, expected, invalid, resolved)
+
+int main(void) {
+    // --- Well-formed input split anywhere ---
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "h\xC3\xA9llo \xE2\x82\xAC \xF0\x9D\x84\x9E!",
+                     L"héllo € \U0001D11E!", 0, TEXT_ENCODING_UTF8),
+          "UTF-8 multibyte sequences split across calls");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF16LE, "a\0\x34\xD8\x1E\xDD" "b\0", L"a\U0001D11Eb", 0, TEXT_ENCODING_UTF16LE),
+          "UTF-16LE surrogate pair split across calls");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF16BE, "\0a\xD8\x34\xDD\x1E\0b", L"a\U0001D11Eb", 0, TEXT_ENCODING_UTF16BE),
+          "UTF-16BE surrogate pair split across calls");
+    CHECK(DECODES_TO(TEXT_ENCODING_LATIN1, "caf\xE9", L"café", 0, TEXT_ENCODING_LATIN1),
+          "Latin-1 bytes map to code points");
+
+    // --- Ill-formed UTF-8: one U+FFFD per maximal invalid subpart ---
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF8, "a\xC0\xAF" "b\xE0\x80\xAF" "c\xF0\x80\x80\xAF",
+                     L"a��b���c����", 9, TEXT_ENCODING_UTF8),
+          "overlong encodings are replaced");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF8, "\xED\xA0\x80x\xED\xBF\xBF", L"���x���", 6,
+                     TEXT_ENCODING_UTF8),
+          "UTF-8 encoded surrogates are replaced");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF8, "\xF4\x90\x80\x80y\xF5z\xF4\x8F\xBF\xBF",
+                     L"����y�z\U0010FFFF", 5, TEXT_ENCODING_UTF8),
+          "code points above U+10FFFF are replaced");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF8, "\xC3(\x80", L"�(�", 2, TEXT_ENCODING_UTF8),
+          "truncated and stray bytes are replaced");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF8, "ab\xE2\x82", L"ab�", 1, TEXT_ENCODING_UTF8),
+          "truncated final UTF-8 sequence");
+
+    // --- Ill-formed UTF-16 ---
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF16LE, "\x34\xD8" "a\0\x1E\xDD", L"�a�", 2, TEXT_ENCODING_UTF16LE),
+          "lone UTF-16 surrogates are replaced");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF16LE, "a\0\x34\xD8", L"a�", 1, TEXT_ENCODING_UTF16LE),
+          "high surrogate at end of input");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF16BE, "\0a\0", L"a�", 1, TEXT_ENCODING_UTF16BE),
+          "odd final UTF-16 byte");
+
+    // --- Byte-order marks, including marks split across calls ---
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xEF\xBB\xBFhi", L"hi", 0, TEXT_ENCODING_UTF8), "UTF-8 BOM");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xFF\xFEh\0i\0", L"hi", 0, TEXT_ENCODING_UTF16LE), "UTF-16LE BOM");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xFE\xFF\0h\0i", L"hi", 0, TEXT_ENCODING_UTF16BE), "UTF-16BE BOM");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF16LE, "\xFF\xFEh\0", L"h", 0, TEXT_ENCODING_UTF16LE),
+          "BOM confirming the given encoding");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xEF\xBB\xBF", L"", 0, TEXT_ENCODING_UTF8), "input that is only a BOM");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xEF\xBB" "A", L"�" "A", 1, TEXT_ENCODING_UTF8),
+          "held BOM prefix that is not a BOM");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xEF\xBB", L"�", 1, TEXT_ENCODING_UTF8),
+          "input ending inside a BOM prefix");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "\xFF", L"�", 1, TEXT_ENCODING_UTF8), "one-byte input");
+    CHECK(DECODES_TO(TEXT_ENCODING_UTF8, "\xFF\xFE" "a", L"��" "a", 2, TEXT_ENCODING_UTF8),
+          "UTF-16 BOM is text when UTF-8 is forced");
+    CHECK(DECODES_TO(TEXT_ENCODING_LATIN1, "\xEF\xBB\xBF", L"ï»¿", 0, TEXT_ENCODING_LATIN1),
+          "Latin-1 has no BOM");
+    CHECK(DECODES_TO(TEXT_ENCODING_AUTO, "", L"", 0, TEXT_ENCODING_AUTO), "empty input");
+
+    // --- Letter helpers, independent of the locale ---
+    static const wchar_t UPPER[] = L"AÀÂÇÈÉÊËÎÏÔÙÛÜŒŸ";
+    static const wchar_t LOWER[] = L"aàâçèéêëîïôùûüœÿ";
+    bool lowered = true;
+    for (size_t k = 0; UPPER[k] != L'\0'; k++) {
+        if (!is_letter(UPPER[k]) || !is_letter(LOWER[k]) || to_lower_letter(UPPER[k]) != (wint_t)LOWER[k] ||
+            to_lower_letter(LOWER[k]) != (wint_t)LOWER[k]) {
+            fprintf(stderr, "  U+%04X\n", (unsigned)UPPER[k]);
+            lowered = false;
+        }
+    }
+    CHECK(lowered, "accented uppercase letters lower to their French forms");
+    CHECK(to_lower_letter(0xDF) == 0xDF && to_lower_letter(0x130) == L'i', "letters without a plain lowercase pair");
+    CHECK(!is_letter(0xD7) && !is_letter(0xF7) && !is_letter(L'1') && !is_letter(L'\'') && !is_letter(REPLACEMENT_CHAR),
+          "signs, digits and U+FFFD are not letters");
+
+    if (failures > 0) {
+        fprintf(stderr, "%d decoder test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All decoder tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+// Tests for the word table (word_freq.h): counting, O(1) reset and merging.
+//
+// Build and run from the repository root:
+//   gcc -O2 -Wall tests/word_freq_test.c -o /tmp/word_freq_test -lm
+//   /tmp/word_freq_test
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include "../word_freq.h"
+
+static int failures = 0;
+
+#define CHECK(cond, name) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s (%s)\n", name, #cond); failures++; } \
+    else { printf("ok: %s\n", name); } \
+} while (0)
+
+// Count of `word` (lowercase) in `table`, or 0 if it is not there
+static double word_count(WordTable *table, const wchar_t *word) {
+    uint32_t length = (uint32_t)wcslen(word);
+    uint32_t hash = WORD_HASH_SEED;
+    for (uint32_t k = 0; k < length; k++) {
+        hash = word_hash_step(hash, (wint_t)word[k]);
+    }
+    const WordEntry *slot = word_table_find_slot(table, word, length, hash, false);
+    return word_slot_live(table, slot) ? slot->count : 0.0;
+}
+
+static void count_text(WordTable *table, const wchar_t *text) {
+    count_words_in_buffer(text, wcslen(text), table);
+}
+
+int main(void) {
+    WordTable document;
+    WordTable total;
+    if (word_table_init(&document) != 0 || word_table_init(&total) != 0) {
+        fprintf(stderr, "FAIL: word_table_init\n");
+        return EXIT_FAILURE;
+    }
+
+    count_text(&document, L"The cat and THE dog, the end.");
+    CHECK(word_count(&document, L"the") == 3.0 && word_count(&document, L"cat") == 1.0,
+          "words are counted case-insensitively");
+    CHECK(document.unique_words == 5 && document.total_words == 7.0, "unique and total counts");
+
+    // Reset drops every word without touching the slot array
+    WordEntry *slots = document.slots;
+    uint32_t generation = document.generation;
+    word_table_merge(&total, &document);
+    word_table_reset(&document);
+    CHECK(document.slots == slots && document.generation == generation + 1, "reset bumps the generation");
+    CHECK(document.unique_words == 0 && document.total_words == 0.0 && document.length_freq[3] == 0.0,
+          "reset clears the totals");
+    CHECK(word_count(&document, L"the") == 0.0, "reset words are gone");
+
+    // The rewound arena is reused; words from before the reset do not leak back
+    WordArenaBlock *head = document.arena.head;
+    count_text(&document, L"le chat et le chien");
+    CHECK(document.arena.head == head && document.unique_words == 4, "arena is reused after a reset");
+    CHECK(word_count(&document, L"le") == 2.0 && word_count(&document, L"cat") == 0.0,
+          "only the new document is counted");
+
+    // Merging sums counts word by word, leaving the source untouched
+    word_table_merge(&total, &document);
+    count_text(&document, L"the");
+    word_table_merge(&total, &document); // "le chat et le chien the"
+    CHECK(word_count(&total, L"the") == 4.0 && word_count(&total, L"le") == 4.0 &&
+          word_count(&total, L"chien") == 2.0, "merge sums counts");
+    CHECK(total.unique_words == 9 && total.total_words == 7.0 + 5.0 + 6.0, "merge sums totals");
+    CHECK(word_count(&document, L"le") == 2.0 && document.total_words == 6.0, "merge leaves the source alone");
+
+    // Enough words to grow the table and add arena blocks, then reset again
+    word_table_reset(&document);
+    wchar_t word[16];
+    for (int i = 0; i < 5000; i++) {
+        swprintf(word, 16, L"w%c%c%c", L'a' + i % 26, L'a' + (i / 26) % 26, L'a' + (i / 676) % 26);
+        count_text(&document, word);
+    }
+    size_t grown_capacity = document.capacity;
+    word_table_merge(&total, &document);
+    word_table_reset(&document);
+    count_text(&document, L"again");
+    CHECK(grown_capacity > WORD_TABLE_INITIAL_CAPACITY && document.capacity == grown_capacity &&
+          document.unique_words == 1 && word_count(&document, L"waaa") == 0.0, "reset after growing");
+    CHECK(word_count(&total, L"waaa") == 1.0 && total.unique_words == 9 + 5000, "grown table merges");
+
+    // A wrapped generation clears the slots once so stale ones stay dead
+    document.generation = UINT32_MAX;
+    for (size_t i = 0; i < document.capacity; i++) {
+        if (document.slots[i].word != NULL) document.slots[i].generation = UINT32_MAX;
+    }
+    word_table_reset(&document);
+    CHECK(document.generation == 1 && word_count(&document, L"again") == 0.0, "generation wrap");
+
+    word_table_free(&document);
+    word_table_free(&total);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d word table test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All word table tests passed\n");
+    return EXIT_SUCCESS;
+}
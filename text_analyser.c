@@ -2,12 +2,22 @@
 #include "buffer_analyser.h" 
 #include "freq_counter.h" 
 #include "histogram.h" 
+#include "word_freq.h"
+#include "stopwords.h"
+#include "compressed_reader.h"
+#include "text_decoder.h"
+#include "segmenter.h"
+#include "batch_analysis.h"
+#include "estimator.h"
+#include "deadline_analysis.h"
+#include "checkpoint.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <wchar.h>
 #include <locale.h>
 #include <string.h>
 #include <stddef.h>
+#include <signal.h>
 
 // Declare the functions used from header files
 FrequencyData extract_frequencies_from_buffer(const wchar_t *buffer, size_t length);
@@ -16,23 +26,16 @@ void perform_final_analysis(const FrequencyData *data, size_t eng_chars, size_t
 void cleanup_frequency_data(FrequencyData *data);
 void print_all_histograms(const FrequencyData *data); 
 
-// --- Configuration ---
-#define WINDOW_SIZE 500 
-#define OVERLAP_SIZE 400 
-#define STEP_SIZE (WINDOW_SIZE - OVERLAP_SIZE)
-#define MIN_WINDOW_SIZE 100 
-
 // --- Helper function to read the entire file into a wide character buffer ---
-wchar_t* read_file_to_buffer(const char *filename, size_t *out_size) {
+// Decoding does not depend on the locale; `decoder` selects the input encoding
+// and reports how many invalid sequences were replaced. The file is read and
+// decoded block by block; `sink` (optional) is offered the text after every
+// block and may stop the read early, in which case the text read so far is returned.
+wchar_t* read_file_to_buffer(const char *filename, TextDecoder *decoder, DecodeSink *sink, size_t *out_size) {
     
     FILE *fptr;
     long file_byte_size;
     
-    // Set locale to handle wide characters (Unicode/UTF-8)
-    if (setlocale(LC_CTYPE, "") == NULL) {
-        fprintf(stderr, "Warning: Could not set system locale.\\n");
-    }
-
     // Use fopen/rb for standard C I/O
     fptr = fopen(filename, "rb"); 
     
@@ -42,6 +45,16 @@ wchar_t* read_file_to_buffer(const char *filename, size_t *out_size) {
         return NULL;
     }
     
+    // Compressed archives are decompressed on a separate thread, without a temporary file
+    unsigned char magic[4];
+    size_t magic_length = fread(magic, 1, sizeof(magic), fptr);
+    InputFormat format = detect_input_format(magic, magic_length);
+    fseek(fptr, 0, SEEK_SET);
+
+    if (format != INPUT_PLAIN) {
+        return read_compressed_to_buffer(fptr, format, decoder, sink, out_size);
+    }
+
     // 1. Get file size in bytes
     fseek(fptr, 0, SEEK_END);
     file_byte_size = ftell(fptr);
@@ -53,142 +66,445 @@ wchar_t* read_file_to_buffer(const char *filename, size_t *out_size) {
         return NULL;
     }
     
-    // 2. Allocate buffer for bytes (plus null terminator)
-    char *byte_buffer = (char*)malloc(file_byte_size + 1);
-    if (byte_buffer == NULL) {
-        fprintf(stderr, "Error: Failed to allocate byte buffer.\\n");
+    // 2. Allocate one block of bytes, and the wide buffer for the whole file
+    //    (every character takes at least one byte, so with room for a flushed
+    //    sequence it never has to grow unless the file does)
+    unsigned char *byte_block = (unsigned char*)malloc(DECODE_BLOCK_SIZE);
+    WideText text = { NULL, 0, 0 };
+    if (byte_block == NULL || wide_text_reserve(&text, (size_t)file_byte_size + 2) != 0) {
+        fprintf(stderr, "Error: Failed to allocate read buffers.\n");
+        free(byte_block);
         fclose(fptr);
+        *out_size = 0;
         return NULL;
     }
 
-    // 3. Read file into byte buffer
-    if (fread(byte_buffer, 1, file_byte_size, fptr) != file_byte_size) {
+    // 3. Read and decode block by block with the built-in decoder (never fails:
+    //    invalid sequences become U+FFFD and are counted in the decoder)
+    size_t bytes_read = 0;
+    size_t block_size = DECODE_FIRST_BLOCK_SIZE;
+    size_t n;
+    while ((n = fread(byte_block, 1, block_size, fptr)) > 0) {
+        if (wide_text_append(&text, decoder, byte_block, n) != 0) {
+            break;
+        }
+        bytes_read += n;
+        block_size = (block_size * 2 < DECODE_BLOCK_SIZE) ? block_size * 2 : DECODE_BLOCK_SIZE;
+        if (!decode_sink_offer(sink, &text, (double)bytes_read / (double)file_byte_size)) {
+            break;
+        }
+    }
+    bool failed = (n > 0 && (sink == NULL || !sink->stopped)) || ferror(fptr);
+    if (ferror(fptr)) {
         fprintf(stderr, "Error reading file into byte buffer.\\n");
-        free(byte_buffer);
-        fclose(fptr);
-        return NULL;
     }
     fclose(fptr);
-    byte_buffer[file_byte_size] = '\0'; // Null-terminate the byte buffer
-
-    // 4. Convert byte buffer (multi-byte UTF-8) to wchar_t buffer (wide characters)
-    size_t wide_chars_needed = mbstowcs(NULL, byte_buffer, 0);
+    free(byte_block);
 
-    if (wide_chars_needed == (size_t)-1) {
-        fprintf(stderr, "Error converting multibyte characters to wide characters (mbstowcs failed).\\n");
-        free(byte_buffer);
+    if (failed) {
+        free(text.data);
         *out_size = 0;
         return NULL;
     }
-    
-    wchar_t *wide_buffer = (wchar_t*)malloc((wide_chars_needed + 1) * sizeof(wchar_t));
-    if (wide_buffer == NULL) {
-        fprintf(stderr, "Error: Failed to allocate wide buffer.\\n");
-        free(byte_buffer);
-        *out_size = 0;
-        return NULL;
+
+    // A read stopped by the sink keeps any sequence cut at the end pending
+    if (sink == NULL || !sink->stopped) {
+        wide_text_finish(&text, decoder);
+    }
+
+    *out_size = text.length;
+    return text.data;
+}
+
+// --- Estimate mode: sampled proportions with confidence intervals ---
+// Returns an exit status, or -1 when the file must be analysed in full instead.
+int run_estimate_mode(const char *filename, TextEncoding encoding, EstimateOptions *options) {
+
+    FILE *fptr = fopen(filename, "rb");
+    if (fptr == NULL) {
+        perror("Error opening file");
+        return EXIT_FAILURE;
+    }
+
+    unsigned char magic[4];
+    size_t magic_length = fread(magic, 1, sizeof(magic), fptr);
+    if (detect_input_format(magic, magic_length) != INPUT_PLAIN) {
+        printf("Note: Compressed input cannot be sampled at random offsets; running the full analysis.\n");
+        fclose(fptr);
+        return -1;
+    }
+
+    if (options->precision <= 0.0) {
+        options->precision = ESTIMATE_DEFAULT_PRECISION;
+    }
+    options->encoding = encoding;
+
+    printf("Estimating file: %s (target +/- %.2f%%", filename, options->precision * 100.0);
+    if (options->budget_ms > 0.0) {
+        printf(", budget %.0f ms", options->budget_ms);
     }
+    printf(")\n");
 
-    mbstowcs(wide_buffer, byte_buffer, wide_chars_needed + 1);
+    EstimateResult result;
+    int status = run_estimate(fptr, options, &result);
+    fclose(fptr);
+    if (status != 0) {
+        return EXIT_FAILURE;
+    }
 
-    free(byte_buffer);
-    *out_size = wide_chars_needed;
-    return wide_buffer;
+    print_estimate_report(&result);
+    return EXIT_SUCCESS;
 }
 
+// --- Checkpointing: a preempted job (SIGTERM/SIGINT) saves its progress before exiting ---
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int signum) {
+    (void)signum;
+    stop_requested = 1;
+}
+
+// Runs the sliding windows and the whole-document counts to the end of the
+// buffer. With a checkpoint path the state is saved every `interval` seconds
+// and on SIGTERM/SIGINT. A failed periodic save only warns (the next one may
+// succeed); the run goes on. Returns false if the run stopped before the end.
+bool run_analysis(const wchar_t *buffer, size_t length, AnalysisProgress *progress,
+                  const char *checkpoint_path, const CheckpointIdentity *identity, double interval) {
+    Deadline next_checkpoint;
+    deadline_start(&next_checkpoint, interval);
+
+    if (checkpoint_path != NULL) {
+        signal(SIGTERM, request_stop);
+        signal(SIGINT, request_stop);
+    }
+
+    size_t windows_done = 0;
+    for (;;) {
+        bool more = window_scan_step(&progress->windows, buffer, length, true);
+
+        // Fold the characters the windows have moved past in large slices (everything once they stop)
+        size_t target = more ? progress->windows.position : length;
+        if (!more || target >= progress->counted + ANALYSIS_FOLD_CHARS) {
+            analysis_progress_advance(progress, buffer, length, target);
+        }
+        if (!more) break;
+
+        // The clock is read every CHECKPOINT_CLOCK_WINDOWS windows only
+        if (checkpoint_path == NULL || (++windows_done % CHECKPOINT_CLOCK_WINDOWS != 0 && !stop_requested)) {
+            continue;
+        }
+        if (stop_requested || deadline_passed(&next_checkpoint)) {
+            analysis_progress_advance(progress, buffer, length, progress->windows.position);
+            bool saved = (checkpoint_save(checkpoint_path, identity, progress) == 0);
+            if (stop_requested) {
+                if (saved) {
+                    fprintf(stderr, "Interrupted: progress saved to '%s' (resume with --resume).\n", checkpoint_path);
+                } else {
+                    fprintf(stderr, "Interrupted: progress could not be saved to '%s'.\n", checkpoint_path);
+                }
+                return false;
+            }
+            if (!saved) {
+                fprintf(stderr, "Warning: Checkpoint not saved; the analysis continues and retries in %g s.\n",
+                        interval);
+            }
+            deadline_start(&next_checkpoint, interval);
+        }
+    }
+    return true;
+}
+
+// --- Streaming: windows and whole-document counts start while the file is still being read ---
+typedef struct StreamedAnalysis {
+    AnalysisProgress *progress;
+    WindowLog log; // Window verdicts, printed once the report header is out
+} StreamedAnalysis;
+
+// DecodeSink callback: classifies every full window of the text so far and
+// folds the whole-document counts up to a word boundary behind them. What
+// depends on the end of the input (the last, shorter windows and a word cut
+// by the block boundary) is left to run_analysis.
+static bool analyse_streamed_text(DecodeSink *sink, const wchar_t *text, size_t length) {
+    StreamedAnalysis *streamed = (StreamedAnalysis *)sink->context;
+    AnalysisProgress *progress = streamed->progress;
+    WindowScan *windows = &progress->windows;
+
+    if (windows->position + WINDOW_SIZE > length) {
+        return true;
+    }
+    size_t full_windows = (length - WINDOW_SIZE - windows->position) / STEP_SIZE + 1;
+    if (window_log_reserve(&streamed->log, full_windows) != 0) {
+        return true; // run_analysis carries on from here once the file is read
+    }
+    for (size_t w = 0; w < full_windows; w++) {
+        window_scan_step(windows, text, length, true);
+    }
+
+    size_t cut = windows->position;
+    while (cut < length && is_word_char(text[cut])) {
+        cut++;
+    }
+    if (cut < length && cut >= progress->counted + ANALYSIS_FOLD_CHARS) {
+        analysis_progress_advance(progress, text, length, cut);
+    }
+    return true;
+}
+
+// --- Deadline mode: the budget covers the whole run, from program start ---
+// The prefix and window stages run on each block as it is read, and the read
+// stops at the deadline, so a verdict never waits for the whole file. Reports
+// are printed only for what finished in time; histograms only if the full pass
+// completed with time to spare.
+int run_deadline_mode(const char *filename, TextDecoder *decoder, const Deadline *deadline) {
+    DeadlineAnalysis analysis;
+    deadline_analysis_init(&analysis, deadline);
+    DecodeSink sink = { deadline_analysis_sink, &analysis, 0.0, false };
+
+    size_t length = 0;
+    wchar_t *buffer = read_file_to_buffer(filename, decoder, &sink, &length);
+    if (buffer == NULL || length < STOPWORD_MIN_WINDOW_SIZE) {
+        fprintf(stderr, "Error: File '%s' is empty, cannot be read, or is too short (%zu chars) for analysis.\n", filename, length);
+        free(buffer);
+        return EXIT_FAILURE;
+    }
+
+    if (sink.stopped) {
+        printf("Analyzing file: %s (Wide characters read before the deadline: %zu)\n", filename, length);
+    } else {
+        printf("Analyzing file: %s (Total wide characters: %zu)\n", filename, length);
+    }
+    printf("Window Size: %d | Overlap: %d | Step: %d\n", WINDOW_SIZE, OVERLAP_SIZE, STEP_SIZE);
+    if (decoder->invalid_sequences > 0) {
+        printf("Warning: %zu invalid byte sequences replaced with U+FFFD\n", decoder->invalid_sequences);
+    }
+
+    // The last, shorter windows and the whole-document pass need all of the input
+    if (!sink.stopped) {
+        deadline_analysis_feed(&analysis, buffer, length, true);
+    }
+
+    DeadlineResult result;
+    deadline_analysis_result(&analysis, length, sink.stopped ? sink.input_fraction : 1.0, &result);
+    print_deadline_report(&result, deadline->budget_ms);
+
+    if (result.stage == STAGE_FULL) {
+        if (!deadline_passed(deadline)) {
+            perform_final_analysis(&result.full, result.eng_chars, result.fre_chars);
+            print_all_histograms(&result.full);
+        }
+        cleanup_frequency_data(&result.full);
+    }
+    free(buffer);
+    return EXIT_SUCCESS;
+}
 
 int main(int argc, char *argv[]) {
     
+    // A --deadline-ms budget counts from here: setup and reading are part of it
+    Deadline deadline;
+    deadline_start(&deadline, 0.0);
+
+    if (init_stopword_table() != 0) {
+        return EXIT_FAILURE;
+    }
+
     // --- 1. File Reading and Setup ---
-    const char *filename;
+    const char *filename = NULL;
+    TextEncoding encoding = TEXT_ENCODING_AUTO;
+    bool batch_mode = false;
+    BatchOptions batch_options = { TEXT_ENCODING_AUTO, BATCH_DEFAULT_QUEUE_DEPTH, 0, true };
+    const char *checkpoint_path = NULL;
+    double checkpoint_interval = CHECKPOINT_DEFAULT_INTERVAL;
+    bool resume = false;
+    bool estimate_mode = false;
+    EstimateOptions estimate_options = { TEXT_ENCODING_AUTO, ESTIMATE_DEFAULT_PRECISION, 0.0, 0 };
+    char **inputs = (char **)malloc((size_t)argc * sizeof(char *));
+    size_t input_count = 0;
+
+    if (inputs == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the argument list.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Options start with "--"; the first other argument is the file to analyse
+    // (in --batch mode every other argument is a file or directory)
+    for (int arg = 1; arg < argc; arg++) {
+        if (strncmp(argv[arg], "--encoding=", 11) == 0) {
+            if (parse_text_encoding(argv[arg] + 11, &encoding) != 0) {
+                fprintf(stderr, "Error: Unknown encoding '%s' (use auto, utf8, latin1, utf16le or utf16be).\n", argv[arg] + 11);
+                free(inputs);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[arg], "--batch") == 0) {
+            batch_mode = true;
+        } else if (strncmp(argv[arg], "--queue-depth=", 14) == 0) {
+            batch_options.queue_depth = (unsigned)strtoul(argv[arg] + 14, NULL, 10);
+        } else if (strncmp(argv[arg], "--workers=", 10) == 0) {
+            batch_options.workers = (unsigned)strtoul(argv[arg] + 10, NULL, 10);
+        } else if (strcmp(argv[arg], "--no-uring") == 0) {
+            batch_options.prefer_uring = false;
+        } else if (strcmp(argv[arg], "--estimate") == 0) {
+            estimate_mode = true;
+        } else if (strncmp(argv[arg], "--precision=", 12) == 0) {
+            estimate_options.precision = strtod(argv[arg] + 12, NULL) / 100.0;
+        } else if (strncmp(argv[arg], "--budget-ms=", 12) == 0) {
+            estimate_options.budget_ms = strtod(argv[arg] + 12, NULL);
+        } else if (strncmp(argv[arg], "--deadline-ms=", 14) == 0) {
+            deadline.budget_ms = strtod(argv[arg] + 14, NULL);
+        } else if (strncmp(argv[arg], "--checkpoint=", 13) == 0) {
+            checkpoint_path = argv[arg] + 13;
+        } else if (strncmp(argv[arg], "--checkpoint-interval=", 22) == 0) {
+            checkpoint_interval = strtod(argv[arg] + 22, NULL);
+            if (!(checkpoint_interval > 0.0)) {
+                fprintf(stderr, "Error: --checkpoint-interval needs a positive number of seconds.\n");
+                free(inputs);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[arg], "--resume") == 0) {
+            resume = true;
+        } else if (strncmp(argv[arg], "--seed=", 7) == 0) {
+            estimate_options.seed = strtoull(argv[arg] + 7, NULL, 10);
+        } else {
+            inputs[input_count++] = argv[arg];
+        }
+    }
+
+    if (resume && checkpoint_path == NULL) {
+        fprintf(stderr, "Error: --resume needs --checkpoint=FILE.\n");
+        free(inputs);
+        return EXIT_FAILURE;
+    }
+
+    // The locale only matters for classifying letters outside Latin-1/Latin
+    // Extended-A; every mode uses the same one
+    if (setlocale(LC_CTYPE, "") == NULL) {
+        fprintf(stderr, "Warning: Could not set system locale.\n");
+    }
 
-    if (argc < 2) {
+    if (batch_mode) {
+        batch_options.encoding = encoding;
+        int status = run_batch_analysis(inputs, input_count, &batch_options);
+        free(inputs);
+        return status;
+    }
+
+    if (input_count > 0) {
+        filename = inputs[0];
+    }
+    free(inputs);
+
+    if (filename == NULL) {
         // Use "hello.txt" as default if no argument is provided
         filename = "hello.txt";
         printf("No filename provided. Using default file: %s\n", filename);
-    } else {
-        // Use the filename provided on the command line
-        filename = argv[1];
+    }
+
+    // --- 1b. Sampled Estimate (reads only the sampled windows) ---
+    if (estimate_mode) {
+        int status = run_estimate_mode(filename, encoding, &estimate_options);
+        if (status >= 0) {
+            return status;
+        }
+        // Not seekable (compressed input): fall through to the full analysis
     }
     
+    TextDecoder decoder;
+    text_decoder_init(&decoder, encoding);
+
+    // --- 1c. Deadline-Bounded Analysis (best verdict within the budget) ---
+    if (deadline.budget_ms > 0.0) {
+        return run_deadline_mode(filename, &decoder, &deadline);
+    }
+
+    // --- 2. Analysis State (window verdicts, whole-document counts, word table) ---
+    AnalysisProgress progress;
+    if (analysis_progress_init(&progress) != 0) {
+        analysis_progress_free(&progress);
+        return EXIT_FAILURE;
+    }
+
+    // The analysis starts on the first blocks while the rest of the file is read
+    // and decompressed. Not with checkpoints: they identify the input by its
+    // decoded length and are only saved (or resumed) once it is known.
+    StreamedAnalysis streamed;
+    memset(&streamed, 0, sizeof(streamed));
+    streamed.progress = &progress;
+    DecodeSink sink = { analyse_streamed_text, &streamed, 0.0, false };
+    bool streaming = (checkpoint_path == NULL);
+    if (streaming) {
+        progress.windows.log = &streamed.log;
+    }
+
     size_t file_length = 0;
-    wchar_t *file_buffer = read_file_to_buffer(filename, &file_length);
+    wchar_t *file_buffer = read_file_to_buffer(filename, &decoder, streaming ? &sink : NULL, &file_length);
+    progress.windows.log = NULL;
 
-    if (file_buffer == NULL || file_length < MIN_WINDOW_SIZE) {
+    // Short messages are still accepted: the stopword fast path can decide them
+    if (file_buffer == NULL || file_length < STOPWORD_MIN_WINDOW_SIZE) {
         fprintf(stderr, "Error: File '%s' is empty, cannot be read, or is too short (%zu chars) for analysis.\\n", filename, file_length);
+        free(streamed.log.verdicts);
+        analysis_progress_free(&progress);
         free(file_buffer);
         return EXIT_FAILURE;
     }
 
     printf("Analyzing file: %s (Total wide characters: %zu)\n", filename, file_length);
     printf("Window Size: %d | Overlap: %d | Step: %d\n", WINDOW_SIZE, OVERLAP_SIZE, STEP_SIZE);
+    if (decoder.invalid_sequences > 0) {
+        printf("Warning: %zu invalid byte sequences replaced with U+FFFD\n", decoder.invalid_sequences);
+    }
 
-    // --- 2. Variables for Segmentation Aggregation ---
-    size_t eng_chars_from_segments = 0;
-    size_t fre_chars_from_segments = 0;
-    
-    // --- 3. Sliding Window Loop (FINAL ROBUST LOGIC) ---
-    size_t i = 0;
-    
-    while (i < file_length) {
-        
-        // Determine the window size (handle the final, possibly smaller segment)
-        size_t current_window_size = (i + WINDOW_SIZE <= file_length) ? WINDOW_SIZE : file_length - i;
-        
-        // Determine the size of the non-overlapping segment for aggregation
-        size_t count_to_add = (i + STEP_SIZE <= file_length) ? STEP_SIZE : file_length - i;
-        
-        // Determine where the window starts next
-        size_t next_i = i + STEP_SIZE;
-        
-        // CRITICAL BREAK: Stop processing if the remaining available segment is too small 
-        if (current_window_size < MIN_WINDOW_SIZE) {
-            break; 
-        }
+    CheckpointIdentity identity;
+    memset(&identity, 0, sizeof(identity));
+    if (checkpoint_path != NULL &&
+        checkpoint_identify(filename, (uint32_t)encoding, file_length, &identity) != 0) {
+        free(streamed.log.verdicts);
+        analysis_progress_free(&progress);
+        free(file_buffer);
+        return EXIT_FAILURE;
+    }
 
-        // If count_to_add is zero, break.
-        if (count_to_add < 1) break; 
-        
-        // Extract frequencies for the current window slice
-        FrequencyData segment_data = extract_frequencies_from_buffer(file_buffer + i, current_window_size);
-        
-        printf("Chars %05zu-%05zu: ", i, i + current_window_size - 1);
-        
-        if (segment_data.error_code == 0) {
-            int lang_id = perform_segment_test(&segment_data);
-            
-            // --- CORE LOGIC: Accumulate the non-overlapping count ---
-            if (lang_id == LANG_ENG) {
-                printf("=> ENGLISH (Adding %zu chars)\n", count_to_add);
-                eng_chars_from_segments += count_to_add;
-            } else if (lang_id == LANG_FRE) {
-                printf("=> FRENCH (Adding %zu chars)\n", count_to_add);
-                fre_chars_from_segments += count_to_add;
-            }
+    if (resume) {
+        int loaded = checkpoint_load(checkpoint_path, &identity, &progress);
+        if (loaded < 0) {
+            analysis_progress_free(&progress);
+            free(file_buffer);
+            return EXIT_FAILURE;
+        }
+        if (loaded == 0) {
+            printf("Resuming from checkpoint '%s' at char %zu (%.1f%% done)\n", checkpoint_path,
+                   progress.windows.position, (double)progress.counted / (double)file_length * 100.0);
         } else {
-            printf("=> SKIPPED (No letters found in segment)\n");
+            printf("No checkpoint at '%s' yet, starting from the beginning\n", checkpoint_path);
         }
-        
-        cleanup_frequency_data(&segment_data); 
-        
-        // Move the window to the next step
-        i = next_i;
+    }
+
+    // --- 3. Sliding Window Loop (whole-document counts advance with it) ---
+    window_log_print(&streamed.log); // Windows classified while the file was read
+    if (!run_analysis(file_buffer, file_length, &progress,
+                      checkpoint_path, &identity, checkpoint_interval)) {
+        analysis_progress_free(&progress);
+        free(file_buffer);
+        return EXIT_FAILURE;
     }
 
     printf("\n--- Segmentation Complete ---\n");
     
     // --- 4. Final Aggregated Report (Uses Segment Proportions) ---
-    // Extract frequencies for the entire document for the final Chi-Squared score.
-    FrequencyData final_analysis_data = extract_frequencies_from_buffer(file_buffer, file_length);
-
     // Pass the non-overcounted character totals
-    perform_final_analysis(&final_analysis_data, eng_chars_from_segments, fre_chars_from_segments);
+    perform_final_analysis(&progress.full, progress.windows.eng_chars, progress.windows.fre_chars);
 
     // --- 5. Histogram Reporting ---
-    print_all_histograms(&final_analysis_data);
+    print_all_histograms(&progress.full);
 
-    // --- 6. Cleanup ---
-    cleanup_frequency_data(&final_analysis_data);
+    // --- 6. Vocabulary Statistics (Word Frequencies) ---
+    print_word_histogram(&progress.words);
+
+    // --- 7. Cleanup ---
+    if (checkpoint_path != NULL) {
+        remove(checkpoint_path); // The run is complete: nothing left to resume
+    }
+    analysis_progress_free(&progress);
     free(file_buffer);
 
     return EXIT_SUCCESS;
@@ -0,0 +1,416 @@
+#ifndef TEXT_DECODER_H
+#define TEXT_DECODER_H
+
+#include <wchar.h>
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint32_t, uint64_t
+#include <stdlib.h> // For realloc
+#include <string.h> // For memcpy, strcmp
+#include <stdio.h>  // For fputs
+
+// Built-in, locale-independent decoder from raw bytes to wchar_t. Unlike
+// mbstowcs it never rejects input: every invalid or truncated sequence becomes
+// U+FFFD and is counted in `invalid_sequences`. It is incremental, so input may
+// be fed in arbitrary blocks (see compressed_reader.h).
+
+#define REPLACEMENT_CHAR 0xFFFD
+
+// Worst case wide characters produced by one text_decoder_decode call
+#define TEXT_DECODER_MAX_OUTPUT(byte_length) ((byte_length) + 1)
+
+typedef enum {
+    TEXT_ENCODING_AUTO = 0, // BOM sniffing, UTF-8 otherwise
+    TEXT_ENCODING_UTF8,
+    TEXT_ENCODING_LATIN1,
+    TEXT_ENCODING_UTF16LE,
+    TEXT_ENCODING_UTF16BE
+} TextEncoding;
+
+typedef struct TextDecoder {
+    TextEncoding encoding;
+    bool at_start;            // Nothing decoded yet (BOM handling)
+    unsigned char bom[2];     // Leading bytes that may still begin a byte-order mark
+    int bom_length;
+
+    // UTF-8 state
+    uint32_t code_point;      // Partially assembled code point
+    int pending;              // Continuation bytes still expected
+    unsigned char lower;      // Valid range for the next continuation byte
+    unsigned char upper;
+
+    // UTF-16 state
+    bool have_byte;           // First byte of a code unit seen
+    unsigned char first_byte;
+    uint32_t high_surrogate;  // Waiting for its low half (0 if none)
+
+    size_t invalid_sequences;
+} TextDecoder;
+
+// Parses the --encoding option value; returns -1 if it is not recognised
+static inline int parse_text_encoding(const char *name, TextEncoding *out) {
+    if (strcmp(name, "auto") == 0) *out = TEXT_ENCODING_AUTO;
+    else if (strcmp(name, "utf8") == 0 || strcmp(name, "utf-8") == 0) *out = TEXT_ENCODING_UTF8;
+    else if (strcmp(name, "latin1") == 0 || strcmp(name, "iso-8859-1") == 0) *out = TEXT_ENCODING_LATIN1;
+    else if (strcmp(name, "utf16le") == 0 || strcmp(name, "utf-16le") == 0) *out = TEXT_ENCODING_UTF16LE;
+    else if (strcmp(name, "utf16be") == 0 || strcmp(name, "utf-16be") == 0) *out = TEXT_ENCODING_UTF16BE;
+    else return -1;
+    return 0;
+}
+
+static inline void text_decoder_init(TextDecoder *dec, TextEncoding encoding) {
+    memset(dec, 0, sizeof(TextDecoder));
+    dec->encoding = encoding;
+    dec->at_start = true;
+}
+
+// Appends one code point, splitting it into a surrogate pair where wchar_t is 16 bits
+static inline size_t text_decoder_emit(wchar_t *dst, size_t n, uint32_t cp) {
+#if WCHAR_MAX <= 0xFFFF
+    if (cp > 0xFFFF) {
+        cp -= 0x10000;
+        dst[n++] = (wchar_t)(0xD800 + (cp >> 10));
+        dst[n++] = (wchar_t)(0xDC00 + (cp & 0x3FF));
+        return n;
+    }
+#endif
+    dst[n++] = (wchar_t)cp;
+    return n;
+}
+
+// =======================================================
+// UTF-8 (Unicode Table 3-7 well-formed sequences only)
+// =======================================================
+static inline size_t decode_utf8(TextDecoder *dec, const unsigned char *src, size_t length, wchar_t *dst) {
+    size_t n = 0;
+    size_t i = 0;
+
+    while (i < length) {
+        unsigned char b = src[i];
+
+        if (dec->pending == 0) {
+            if (b < 0x80) {
+                // ASCII fast path: eight bytes at a time while no high bit is set
+                while (i + 8 <= length) {
+                    uint64_t chunk;
+                    memcpy(&chunk, src + i, sizeof(chunk));
+                    if (chunk & 0x8080808080808080ull) break;
+                    for (int k = 0; k < 8; k++) {
+                        dst[n + k] = (wchar_t)src[i + k];
+                    }
+                    n += 8;
+                    i += 8;
+                }
+                if (i < length && src[i] < 0x80) {
+                    dst[n++] = (wchar_t)src[i++];
+                }
+                continue;
+            }
+
+            if (b >= 0xC2 && b <= 0xDF) {
+                dec->code_point = b & 0x1F;
+                dec->pending = 1;
+                dec->lower = 0x80;
+                dec->upper = 0xBF;
+            } else if (b >= 0xE0 && b <= 0xEF) {
+                dec->code_point = b & 0x0F;
+                dec->pending = 2;
+                dec->lower = (b == 0xE0) ? 0xA0 : 0x80; // No overlongs
+                dec->upper = (b == 0xED) ? 0x9F : 0xBF; // No surrogates
+            } else if (b >= 0xF0 && b <= 0xF4) {
+                dec->code_point = b & 0x07;
+                dec->pending = 3;
+                dec->lower = (b == 0xF0) ? 0x90 : 0x80; // No overlongs
+                dec->upper = (b == 0xF4) ? 0x8F : 0xBF; // Nothing above U+10FFFF
+            } else {
+                // Stray continuation byte or invalid lead byte
+                dec->invalid_sequences++;
+                dst[n++] = REPLACEMENT_CHAR;
+            }
+            i++;
+            continue;
+        }
+
+        if (b < dec->lower || b > dec->upper) {
+            // Truncated sequence: replace it and re-read this byte as a new lead
+            dec->invalid_sequences++;
+            dst[n++] = REPLACEMENT_CHAR;
+            dec->pending = 0;
+            continue;
+        }
+
+        dec->code_point = (dec->code_point << 6) | (b & 0x3F);
+        dec->lower = 0x80;
+        dec->upper = 0xBF;
+        if (--dec->pending == 0) {
+            n = text_decoder_emit(dst, n, dec->code_point);
+        }
+        i++;
+    }
+    return n;
+}
+
+// =======================================================
+// LATIN-1 (every byte maps to the code point of the same value)
+// =======================================================
+static inline size_t decode_latin1(const unsigned char *src, size_t length, wchar_t *dst) {
+    for (size_t i = 0; i < length; i++) {
+        dst[i] = (wchar_t)src[i];
+    }
+    return length;
+}
+
+// =======================================================
+// UTF-16 (LE or BE)
+// =======================================================
+static inline size_t decode_utf16(TextDecoder *dec, const unsigned char *src, size_t length, wchar_t *dst) {
+    bool little_endian = (dec->encoding == TEXT_ENCODING_UTF16LE);
+    size_t n = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        if (!dec->have_byte) {
+            dec->first_byte = src[i];
+            dec->have_byte = true;
+            continue;
+        }
+        dec->have_byte = false;
+
+        uint32_t unit = little_endian ? (uint32_t)(dec->first_byte | (src[i] << 8))
+                                      : (uint32_t)((dec->first_byte << 8) | src[i]);
+
+        if (dec->high_surrogate != 0) {
+            if (unit >= 0xDC00 && unit <= 0xDFFF) {
+                uint32_t cp = 0x10000 + ((dec->high_surrogate - 0xD800) << 10) + (unit - 0xDC00);
+                dec->high_surrogate = 0;
+                n = text_decoder_emit(dst, n, cp);
+                continue;
+            }
+            dec->invalid_sequences++;
+            dst[n++] = REPLACEMENT_CHAR;
+            dec->high_surrogate = 0;
+        }
+
+        if (unit >= 0xD800 && unit <= 0xDBFF) {
+            dec->high_surrogate = unit;
+        } else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+            dec->invalid_sequences++; // Unpaired low surrogate
+            dst[n++] = REPLACEMENT_CHAR;
+        } else {
+            dst[n++] = (wchar_t)unit;
+        }
+    }
+    return n;
+}
+
+// =======================================================
+// BYTE-ORDER MARK
+// =======================================================
+// Matches the first `count` bytes of the input against the byte-order marks
+// the encoding allows. Returns the BOM's length, 0 if there is none, or -1 if
+// the bytes so far are the start of one.
+static inline int text_decoder_match_bom(const TextDecoder *dec, const unsigned char *bytes, size_t count) {
+    static const struct { unsigned char bytes[3]; int length; TextEncoding encoding; } BOMS[] = {
+        { { 0xEF, 0xBB, 0xBF }, 3, TEXT_ENCODING_UTF8 },
+        { { 0xFF, 0xFE, 0x00 }, 2, TEXT_ENCODING_UTF16LE },
+        { { 0xFE, 0xFF, 0x00 }, 2, TEXT_ENCODING_UTF16BE },
+    };
+
+    for (size_t b = 0; b < sizeof(BOMS) / sizeof(BOMS[0]); b++) {
+        if (dec->encoding != TEXT_ENCODING_AUTO && dec->encoding != BOMS[b].encoding) continue;
+
+        size_t compare = (count < (size_t)BOMS[b].length) ? count : (size_t)BOMS[b].length;
+        if (memcmp(bytes, BOMS[b].bytes, compare) != 0) continue;
+        return (compare == (size_t)BOMS[b].length) ? BOMS[b].length : -1;
+    }
+    return 0;
+}
+
+// =======================================================
+// PUBLIC ENTRY POINTS
+// =======================================================
+static inline size_t text_decoder_decode_body(TextDecoder *dec, const unsigned char *src, size_t length, wchar_t *dst) {
+    switch (dec->encoding) {
+        case TEXT_ENCODING_LATIN1:
+            return decode_latin1(src, length, dst);
+        case TEXT_ENCODING_UTF16LE:
+        case TEXT_ENCODING_UTF16BE:
+            return decode_utf16(dec, src, length, dst);
+        default:
+            return decode_utf8(dec, src, length, dst);
+    }
+}
+
+// Decodes one block. `dst` must hold TEXT_DECODER_MAX_OUTPUT(length) characters.
+// Returns the number of wide characters written.
+static inline size_t text_decoder_decode(TextDecoder *dec, const unsigned char *src, size_t length, wchar_t *dst) {
+    size_t n = 0;
+
+    // A byte-order mark selects (or confirms) the encoding and is never counted
+    // as text. A mark split across blocks is held back until it is complete.
+    if (dec->at_start && length > 0) {
+        unsigned char head[3];
+        size_t held = (size_t)dec->bom_length;
+        size_t taken = (length < sizeof(head) - held) ? length : sizeof(head) - held;
+        memcpy(head, dec->bom, held);
+        memcpy(head + held, src, taken);
+
+        int bom = text_decoder_match_bom(dec, head, held + taken);
+        if (bom < 0) {
+            memcpy(dec->bom + held, src, taken); // Every byte of this block is held
+            dec->bom_length += (int)taken;
+            return 0;
+        }
+
+        dec->at_start = false;
+        dec->bom_length = 0;
+        if (bom == 3) {
+            dec->encoding = TEXT_ENCODING_UTF8;
+        } else if (bom == 2) {
+            dec->encoding = (head[0] == 0xFF) ? TEXT_ENCODING_UTF16LE : TEXT_ENCODING_UTF16BE;
+        } else if (dec->encoding == TEXT_ENCODING_AUTO) {
+            dec->encoding = TEXT_ENCODING_UTF8;
+        }
+
+        if ((size_t)bom >= held) {
+            src += (size_t)bom - held;
+            length -= (size_t)bom - held;
+        } else {
+            // Held bytes that were not a mark after all: at most one character
+            n = text_decoder_decode_body(dec, head, held, dst);
+        }
+    }
+
+    return n + text_decoder_decode_body(dec, src, length, dst + n);
+}
+
+// Flushes a sequence left incomplete at end of input. Writes at most one character.
+static inline size_t text_decoder_finish(TextDecoder *dec, wchar_t *dst) {
+    if (dec->at_start && dec->bom_length > 0) {
+        // The input ended inside what could have been a byte-order mark
+        size_t held = (size_t)dec->bom_length;
+        dec->at_start = false;
+        dec->bom_length = 0;
+        if (dec->encoding == TEXT_ENCODING_AUTO) dec->encoding = TEXT_ENCODING_UTF8;
+        size_t n = text_decoder_decode_body(dec, dec->bom, held, dst);
+        if (n > 0) return n;
+    }
+    if (dec->pending != 0 || dec->have_byte || dec->high_surrogate != 0) {
+        dec->pending = 0;
+        dec->have_byte = false;
+        dec->high_surrogate = 0;
+        dec->invalid_sequences++;
+        dst[0] = REPLACEMENT_CHAR;
+        return 1;
+    }
+    return 0;
+}
+
+// =======================================================
+// INCREMENTAL READING: blocks -> growing wide buffer
+// =======================================================
+typedef struct WideText {
+    wchar_t *data;
+    size_t length;
+    size_t capacity; // Characters, not counting the terminator
+} WideText;
+
+// Readers offer the text decoded so far to an optional sink after every block,
+// so analysis can start before the rest of the input is read.
+typedef struct DecodeSink DecodeSink;
+struct DecodeSink {
+    // `text` may move between calls. Returning false stops the read early.
+    bool (*on_text)(DecodeSink *sink, const wchar_t *text, size_t length);
+    void *context;
+    double input_fraction; // Share of the input bytes consumed, set before each call
+    bool stopped;          // on_text ended the read before the end of the input
+};
+
+// Makes room for `needed` characters plus the terminator
+static inline int wide_text_reserve(WideText *text, size_t needed) {
+    if (needed <= text->capacity && text->data != NULL) {
+        return 0;
+    }
+    size_t capacity = (text->capacity > 0) ? text->capacity : needed;
+    while (capacity < needed) capacity *= 2;
+
+    wchar_t *grown = (wchar_t *)realloc(text->data, (capacity + 1) * sizeof(wchar_t));
+    if (grown == NULL) {
+        fprintf(stderr, "Error: Failed to grow wide buffer.\n");
+        return -1;
+    }
+    text->data = grown;
+    text->capacity = capacity;
+    return 0;
+}
+
+// Decodes one more block onto the end of `text`. Sequences split across blocks
+// are carried over in the decoder state.
+static inline int wide_text_append(WideText *text, TextDecoder *dec, const unsigned char *src, size_t length) {
+    // Room for this block plus the flush of a truncated final sequence
+    if (wide_text_reserve(text, text->length + TEXT_DECODER_MAX_OUTPUT(length) + 1) != 0) {
+        return -1;
+    }
+    text->length += text_decoder_decode(dec, src, length, text->data + text->length);
+    text->data[text->length] = L'\0';
+    return 0;
+}
+
+// Ends the text once the whole input has been appended
+static inline void wide_text_finish(WideText *text, TextDecoder *dec) {
+    if (text->data == NULL) return;
+    text->length += text_decoder_finish(dec, text->data + text->length);
+    text->data[text->length] = L'\0';
+}
+
+// Hands the text so far to the sink (if any). Returns false if it asked to stop.
+static inline bool decode_sink_offer(DecodeSink *sink, const WideText *text, double input_fraction) {
+    if (sink == NULL) return true;
+    sink->input_fraction = input_fraction;
+    if (!sink->on_text(sink, text->data, text->length)) {
+        sink->stopped = true;
+        return false;
+    }
+    return true;
+}
+
+// =======================================================
+// OUTPUT: wide character -> UTF-8 (independent of the C locale)
+// =======================================================
+// Writes a NUL-terminated UTF-8 sequence into `out` (at least 5 bytes).
+static inline void encode_utf8(wint_t wc, char *out) {
+    uint32_t cp = (uint32_t)wc;
+
+    if (cp >= 0xD800 && cp <= 0xDFFF) cp = REPLACEMENT_CHAR;
+    if (cp > 0x10FFFF) cp = REPLACEMENT_CHAR;
+
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        out[1] = '\0';
+    } else if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        out[2] = '\0';
+    } else if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        out[3] = '\0';
+    } else {
+        out[0] = (char)(0xF0 | (cp >> 18));
+        out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (cp & 0x3F));
+        out[4] = '\0';
+    }
+}
+
+// Prints a wide string as UTF-8 with plain printf
+static inline void print_utf8(const wchar_t *text) {
+    char bytes[5];
+    for (; *text != L'\0'; text++) {
+        encode_utf8((wint_t)*text, bytes);
+        fputs(bytes, stdout);
+    }
+}
+
+#endif // TEXT_DECODER_H
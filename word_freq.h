@@ -0,0 +1,326 @@
+#ifndef WORD_FREQ_H
+#define WORD_FREQ_H
+
+#include <wchar.h>
+#include <wctype.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h> // For uint32_t hashes and generations
+#include <stddef.h> // For size_t
+#include "freq_counter.h" // For is_word_char
+
+// Words are interned into a bump-allocated arena and counted in a flat
+// open-addressing table. Resetting a table for the next document is O(1):
+// the arena rewinds to its first block and every slot is invalidated by
+// bumping the table generation instead of being cleared.
+
+#define WORD_ARENA_BLOCK_CHARS (64 * 1024) // wchar_t per arena block
+#define WORD_TABLE_INITIAL_CAPACITY 1024   // Must be a power of 2
+#define MAX_WORD_LENGTH_BIN 30             // Longer words share the last bin
+
+// =======================================================
+// ARENA (bump allocator for interned word text)
+// =======================================================
+typedef struct WordArenaBlock {
+    struct WordArenaBlock *next;
+    size_t used;     // wchar_t already handed out from this block
+    size_t capacity; // wchar_t available in data[]
+    wchar_t data[];
+} WordArenaBlock;
+
+typedef struct WordArena {
+    WordArenaBlock *head;    // First block, kept across resets
+    WordArenaBlock *current; // Block currently being bumped
+} WordArena;
+
+static inline wchar_t *word_arena_alloc(WordArena *arena, size_t chars) {
+    WordArenaBlock *block = arena->current;
+
+    if (block != NULL && block->capacity - block->used >= chars) {
+        wchar_t *out = block->data + block->used;
+        block->used += chars;
+        return out;
+    }
+
+    // Reuse the next block left over from an earlier document if it is big enough
+    if (block != NULL && block->next != NULL && block->next->capacity >= chars) {
+        block = block->next;
+        block->used = chars;
+        arena->current = block;
+        return block->data;
+    }
+
+    size_t capacity = (chars > WORD_ARENA_BLOCK_CHARS) ? chars : WORD_ARENA_BLOCK_CHARS;
+    WordArenaBlock *new_block = (WordArenaBlock *)malloc(sizeof(WordArenaBlock) + capacity * sizeof(wchar_t));
+    if (new_block == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for word arena block.\n");
+        return NULL;
+    }
+    new_block->capacity = capacity;
+    new_block->used = chars;
+
+    // Splice the new block in after the current one so retained blocks stay reachable
+    if (block == NULL) {
+        new_block->next = NULL;
+        arena->head = new_block;
+    } else {
+        new_block->next = block->next;
+        block->next = new_block;
+    }
+    arena->current = new_block;
+    return new_block->data;
+}
+
+// O(1): later blocks are reset lazily when the bump pointer reaches them
+static inline void word_arena_reset(WordArena *arena) {
+    arena->current = arena->head;
+    if (arena->head != NULL) {
+        arena->head->used = 0;
+    }
+}
+
+static inline void word_arena_free(WordArena *arena) {
+    WordArenaBlock *current = arena->head;
+    while (current != NULL) {
+        WordArenaBlock *temp = current;
+        current = current->next;
+        free(temp);
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+// =======================================================
+// FLAT WORD TABLE
+// =======================================================
+typedef struct WordEntry {
+    const wchar_t *word; // Lowercased, NUL-terminated text owned by the table's arena
+    uint32_t length;
+    uint32_t hash;
+    uint32_t generation; // Slot is live only when equal to the table generation
+    double count;
+} WordEntry;
+
+typedef struct WordTable {
+    WordEntry *slots;
+    size_t capacity;
+    size_t unique_words;
+    uint32_t generation;
+    WordArena arena;
+
+    double total_words;
+    double length_freq[MAX_WORD_LENGTH_BIN + 1]; // Index = word length (0 unused)
+} WordTable;
+
+// Helper structure for sorted reporting (mirrors CountEntry in histogram.h)
+typedef struct WordCountEntry {
+    const wchar_t *word;
+    uint32_t length;
+    double count;
+} WordCountEntry;
+
+// FNV-1a step over a single (already lowercased) wide character
+static inline uint32_t word_hash_step(uint32_t hash, wint_t wc) {
+    hash ^= (uint32_t)wc;
+    return hash * 16777619u;
+}
+
+#define WORD_HASH_SEED 2166136261u
+
+static inline int word_table_init(WordTable *table) {
+    memset(table, 0, sizeof(WordTable));
+    table->slots = (WordEntry *)calloc(WORD_TABLE_INITIAL_CAPACITY, sizeof(WordEntry));
+    if (table->slots == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for word table.\n");
+        return -1;
+    }
+    table->capacity = WORD_TABLE_INITIAL_CAPACITY;
+    table->generation = 1;
+    return 0;
+}
+
+static inline bool word_slot_live(const WordTable *table, const WordEntry *slot) {
+    return slot->generation == table->generation;
+}
+
+// Doubles the slot array, re-placing every live entry
+static inline int word_table_grow(WordTable *table) {
+    size_t new_capacity = table->capacity * 2;
+    WordEntry *new_slots = (WordEntry *)calloc(new_capacity, sizeof(WordEntry));
+    if (new_slots == NULL) {
+        fprintf(stderr, "Error: Failed to grow word table.\n");
+        return -1;
+    }
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < table->capacity; i++) {
+        const WordEntry *slot = &table->slots[i];
+        if (!word_slot_live(table, slot)) continue;
+
+        size_t index = slot->hash & mask;
+        while (new_slots[index].generation == table->generation) {
+            index = (index + 1) & mask;
+        }
+        new_slots[index] = *slot;
+    }
+
+    free(table->slots);
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+    return 0;
+}
+
+// Finds the slot for a word, or the empty slot where it belongs.
+// When lowercase_input is true the probe text is lowercased on the fly.
+static inline WordEntry *word_table_find_slot(WordTable *table, const wchar_t *word, uint32_t length,
+                                              uint32_t hash, bool lowercase_input) {
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+
+    while (word_slot_live(table, &table->slots[index])) {
+        WordEntry *slot = &table->slots[index];
+        if (slot->hash == hash && slot->length == length) {
+            uint32_t k = 0;
+            while (k < length &&
+                   slot->word[k] == (lowercase_input ? (wchar_t)to_lower_letter(word[k]) : word[k])) {
+                k++;
+            }
+            if (k == length) return slot;
+        }
+        index = (index + 1) & mask;
+    }
+    return &table->slots[index];
+}
+
+// Adds `count` occurrences of a word. The text is copied into the arena on first sight.
+static inline void word_table_add(WordTable *table, const wchar_t *word, uint32_t length,
+                                  uint32_t hash, double count, bool lowercase_input) {
+    // Keep the load factor below 0.7 so probe chains stay short
+    if ((table->unique_words + 1) * 10 > table->capacity * 7) {
+        if (word_table_grow(table) != 0) return;
+    }
+
+    WordEntry *slot = word_table_find_slot(table, word, length, hash, lowercase_input);
+
+    if (!word_slot_live(table, slot)) {
+        // One extra slot keeps interned words NUL-terminated for printing
+        wchar_t *text = word_arena_alloc(&table->arena, (size_t)length + 1);
+        if (text == NULL) return;
+        for (uint32_t k = 0; k < length; k++) {
+            text[k] = lowercase_input ? (wchar_t)to_lower_letter(word[k]) : word[k];
+        }
+        text[length] = L'\0';
+
+        slot->word = text;
+        slot->length = length;
+        slot->hash = hash;
+        slot->generation = table->generation;
+        slot->count = 0.0;
+        table->unique_words++;
+    }
+
+    slot->count += count;
+    table->total_words += count;
+    table->length_freq[(length < MAX_WORD_LENGTH_BIN) ? length : MAX_WORD_LENGTH_BIN] += count;
+}
+
+// =======================================================
+// TOKENIZER (same word-char rule as extract_frequencies_from_buffer)
+// =======================================================
+// Callers splitting a document across threads must cut slices on non-word characters.
+static inline void count_words_in_buffer(const wchar_t *buffer, size_t length, WordTable *table) {
+    size_t i = 0;
+
+    while (i < length) {
+        if (!is_word_char(buffer[i])) {
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        uint32_t hash = WORD_HASH_SEED;
+        while (i < length && is_word_char(buffer[i])) {
+            hash = word_hash_step(hash, to_lower_letter(buffer[i]));
+            i++;
+        }
+
+        word_table_add(table, buffer + start, (uint32_t)(i - start), hash, 1.0, true);
+    }
+}
+
+// Folds a per-thread table into `dst`. `src` is left untouched.
+static inline void word_table_merge(WordTable *dst, const WordTable *src) {
+    for (size_t i = 0; i < src->capacity; i++) {
+        const WordEntry *slot = &src->slots[i];
+        if (!word_slot_live(src, slot)) continue;
+        word_table_add(dst, slot->word, slot->length, slot->hash, slot->count, false);
+    }
+}
+
+// =======================================================
+// REPORTING HELPERS
+// =======================================================
+static inline int compare_word_counts(const void *a, const void *b) {
+    const WordCountEntry *wa = (const WordCountEntry *)a;
+    const WordCountEntry *wb = (const WordCountEntry *)b;
+
+    if (wb->count > wa->count) return 1;
+    if (wb->count < wa->count) return -1;
+    return 0;
+}
+
+// Returns a malloc'd array of every live word sorted by descending count.
+// The word pointers stay valid until the table is reset or freed.
+static inline WordCountEntry *word_table_sorted(const WordTable *table, size_t *out_count) {
+    *out_count = 0;
+    if (table->unique_words == 0) return NULL;
+
+    WordCountEntry *entries = (WordCountEntry *)malloc(table->unique_words * sizeof(WordCountEntry));
+    if (entries == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for word ranking.\n");
+        return NULL;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        const WordEntry *slot = &table->slots[i];
+        if (!word_slot_live(table, slot)) continue;
+        entries[n].word = slot->word;
+        entries[n].length = slot->length;
+        entries[n].count = slot->count;
+        n++;
+    }
+
+    qsort(entries, n, sizeof(WordCountEntry), compare_word_counts);
+    *out_count = n;
+    return entries;
+}
+
+// =======================================================
+// RESET / CLEANUP
+// =======================================================
+// O(1) in the number of words seen: no per-word frees, no slot clearing.
+static inline void word_table_reset(WordTable *table) {
+    table->generation++;
+    if (table->generation == 0) {
+        // Generation counter wrapped: stale slots could look live again, so clear once
+        memset(table->slots, 0, table->capacity * sizeof(WordEntry));
+        table->generation = 1;
+    }
+    word_arena_reset(&table->arena);
+    table->unique_words = 0;
+    table->total_words = 0.0;
+    memset(table->length_freq, 0, sizeof(table->length_freq));
+}
+
+static inline void word_table_free(WordTable *table) {
+    free(table->slots);
+    table->slots = NULL;
+    table->capacity = 0;
+    table->unique_words = 0;
+    word_arena_free(&table->arena);
+}
+
+#endif // WORD_FREQ_H